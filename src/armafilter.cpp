@@ -0,0 +1,206 @@
+#include "armafilter.h"
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <utility>
+
+#include "fft.h"
+
+namespace fssp {
+
+namespace {
+
+template <typename Count>
+inline double dot(const double *a, const double *b, Count count) {
+  // Несколько независимых сумм, чтобы не ждать каждое сложение.
+  double sum[4] = {0, 0, 0, 0};
+
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    sum[0] += a[i] * b[i];
+    sum[1] += a[i + 1] * b[i + 1];
+    sum[2] += a[i + 2] * b[i + 2];
+    sum[3] += a[i + 3] * b[i + 3];
+  }
+  for (; i < count; ++i) sum[0] += a[i] * b[i];
+
+  return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+// Порядки q и p передаются либо числом, либо std::integral_constant -
+// тогда циклы по коэффициентам разворачиваются при компиляции.
+// Коэффициенты в обратном порядке умножаются на отсчеты от самого
+// старого к новому, которые лежат в памяти подряд.
+template <typename MaOrder, typename ArOrder>
+void recursion(const double *ma, MaOrder q, const double *ar, ArOrder p,
+               const double *x, double *y, size_t count) {
+  if (p == 0) {
+    for (size_t i = 0; i < count; ++i) y[i] = x[i] + dot(ma, x + i - q, q);
+    return;
+  }
+
+  // Последний выход держится в регистре: от предыдущего шага зависит
+  // только одно умножение, остальные слагаемые считаются параллельно.
+  double last = ar[p - 1];
+  double previous = y[-1];
+  for (size_t i = 0; i < count; ++i) {
+    double value = x[i] + dot(ma, x + i - q, q) - dot(ar, y + i - p, p - 1);
+    previous = value - last * previous;
+    y[i] = previous;
+  }
+}
+
+constexpr size_t fixedOrders = 5;
+
+typedef void (*Recursion)(const double *, const double *, const double *,
+                          double *, size_t);
+
+template <size_t Q, size_t P>
+void fixedRecursion(const double *ma, const double *ar, const double *x,
+                    double *y, size_t count) {
+  recursion(ma, std::integral_constant<size_t, Q>{}, ar,
+            std::integral_constant<size_t, P>{}, x, y, count);
+}
+
+template <size_t... I>
+constexpr std::array<Recursion, sizeof...(I)> fixedRecursions(
+    std::index_sequence<I...>) {
+  return {&fixedRecursion<I / fixedOrders, I % fixedOrders>...};
+}
+
+constexpr std::array<Recursion, fixedOrders * fixedOrders> recursions =
+    fixedRecursions(std::make_index_sequence<fixedOrders * fixedOrders>{});
+
+}  // namespace
+
+ArmaFilter::ArmaFilter(const std::vector<double> &ma,
+                       const std::vector<double> &ar)
+    : m_ma{ma},
+      m_ar{ar},
+      m_maReversed(ma.rbegin(), ma.rend()),
+      m_arReversed(ar.rbegin(), ar.rend()),
+      m_blockSize{0} {
+  if (std::max(ma.size(), ar.size()) >= blockOrder) prepareBlock();
+
+  reset();
+}
+
+void ArmaFilter::reset() {
+  m_input = std::vector<double>(m_ma.size(), 0.);
+  m_output = std::vector<double>(m_ar.size(), 0.);
+}
+
+void ArmaFilter::prepareBlock() {
+  size_t order = std::max(m_ma.size(), m_ar.size());
+
+  m_blockSize = 4096;
+  while (m_blockSize < 8 * order) m_blockSize *= 2;
+
+  size_t n = 2 * m_blockSize;
+
+  m_maSpectrum = std::vector<base>(n);
+  m_maSpectrum[0] = 1;
+  for (size_t k = 0; k < m_ma.size(); ++k) m_maSpectrum[k + 1] = m_ma[k];
+  fft(m_maSpectrum, false);
+
+  // Импульсная характеристика 1 / A(z) на длине блока.
+  std::vector<double> response(m_blockSize);
+  for (size_t i = 0; i < m_blockSize; ++i) {
+    double value = i == 0 ? 1 : 0;
+    for (size_t k = 0; k < m_ar.size() && k < i; ++k) {
+      value -= m_ar[k] * response[i - 1 - k];
+    }
+    response[i] = value;
+  }
+
+  m_arSpectrum = std::vector<base>(n);
+  std::copy(response.begin(), response.end(), m_arSpectrum.begin());
+  fft(m_arSpectrum, false);
+
+  m_frame = std::vector<base>(n);
+}
+
+void ArmaFilter::process(const double *input, size_t count, double *output) {
+  size_t done = 0;
+
+  if (m_blockSize) {
+    for (; done + m_blockSize <= count; done += m_blockSize) {
+      processBlock(input + done, output + done);
+    }
+  }
+
+  constexpr size_t chunkSize = 4096;
+  for (; done < count; done += chunkSize) {
+    processDirect(input + done, std::min(chunkSize, count - done),
+                  output + done);
+  }
+}
+
+void ArmaFilter::processDirect(const double *input, size_t count,
+                               double *output) {
+  size_t q = m_ma.size();
+  size_t p = m_ar.size();
+
+  m_input.insert(m_input.end(), input, input + count);
+  m_output.resize(p + count);
+
+  const double *x = m_input.data() + q;
+  double *y = m_output.data() + p;
+
+  const double *ma = m_maReversed.data();
+  const double *ar = m_arReversed.data();
+
+  if (q < fixedOrders && p < fixedOrders) {
+    recursions[q * fixedOrders + p](ma, ar, x, y, count);
+  } else {
+    recursion(ma, q, ar, p, x, y, count);
+  }
+
+  std::copy(y, y + count, output);
+
+  m_input.erase(m_input.begin(), m_input.end() - q);
+  m_output.erase(m_output.begin(), m_output.end() - p);
+}
+
+void ArmaFilter::processBlock(const double *input, double *output) {
+  size_t q = m_ma.size();
+  size_t p = m_ar.size();
+  size_t length = m_blockSize;
+
+  // СС часть - перекрытие с сохранением: q старых отсчетов перед блоком.
+  std::fill(m_frame.begin(), m_frame.end(), base(0));
+  for (size_t k = 0; k < q; ++k) m_frame[length - q + k] = m_input[k];
+  for (size_t i = 0; i < length; ++i) m_frame[length + i] = input[i];
+
+  std::copy(input + length - q, input + length, m_input.begin());
+
+  fft(m_frame, false);
+  for (size_t i = 0; i < m_frame.size(); ++i) m_frame[i] *= m_maSpectrum[i];
+  fft(m_frame, true);
+
+  std::vector<double> &u = m_output;
+  u.resize(p + length);
+  for (size_t i = 0; i < length; ++i) u[p + i] = m_frame[length + i].real();
+
+  // Вклад предыдущих выходов переносится во вход блока, после чего
+  // выход равен свертке входа с импульсной характеристикой.
+  for (size_t i = 0; i < p; ++i) {
+    double sum = 0;
+    for (size_t k = i; k < p; ++k) sum += m_ar[k] * u[p + i - 1 - k];
+    u[p + i] -= sum;
+  }
+
+  std::fill(m_frame.begin(), m_frame.end(), base(0));
+  for (size_t i = 0; i < length; ++i) m_frame[i] = u[p + i];
+
+  fft(m_frame, false);
+  for (size_t i = 0; i < m_frame.size(); ++i) m_frame[i] *= m_arSpectrum[i];
+  fft(m_frame, true);
+
+  for (size_t i = 0; i < length; ++i) output[i] = m_frame[i].real();
+
+  m_output.assign(output + length - p, output + length);
+}
+
+}  // namespace fssp
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace fssp {
+
+// Рекурсивный фильтр АРСС:
+// y[n] = x[n] + sum(ma[k] * x[n - 1 - k]) - sum(ar[k] * y[n - 1 - k]).
+// Между вызовами хранятся только последние ma.size() входных и
+// ar.size() выходных отсчетов, данные подаются блоками любой длины.
+// Для больших порядков полные блоки считаются через БПФ.
+class ArmaFilter {
+ public:
+  // Порядок, начиная с которого используется блочная форма.
+  static constexpr size_t blockOrder = 256;
+
+  explicit ArmaFilter(const std::vector<double> &ma,
+                      const std::vector<double> &ar);
+
+  // Допускается output == input.
+  void process(const double *input, size_t count, double *output);
+
+  void reset();
+
+ private:
+  typedef std::complex<double> base;
+
+  void processDirect(const double *input, size_t count, double *output);
+  void processBlock(const double *input, double *output);
+
+  void prepareBlock();
+
+  std::vector<double> m_ma;
+  std::vector<double> m_ar;
+
+  std::vector<double> m_maReversed;
+  std::vector<double> m_arReversed;
+
+  // История и текущий блок подряд: сначала порядок старых отсчетов,
+  // затем новые.
+  std::vector<double> m_input;
+  std::vector<double> m_output;
+
+  size_t m_blockSize;
+
+  // Спектры СС части и импульсной характеристики АР части длиной
+  // m_blockSize, дополненные нулями до 2 * m_blockSize.
+  std::vector<base> m_maSpectrum;
+  std::vector<base> m_arSpectrum;
+  std::vector<base> m_frame;
+};
+
+}  // namespace fssp
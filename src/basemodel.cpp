@@ -1,7 +1,11 @@
 #include "basemodel.h"
 
+#include <QSignalBlocker>
+#include <cmath>
 #include <limits>
 
+#include "parallel.h"
+
 namespace fssp {
 
 BaseModel::BaseModel(std::shared_ptr<SignalData> signalData, QWidget *parent) {
@@ -23,9 +27,13 @@ void BaseModel::createFields() {
   p_freqSpinBox = new QDoubleSpinBox();
   p_freqSpinBox->setDecimals(6);
   p_freqSpinBox->setRange(0, INT_MAX);
+  connect(p_freqSpinBox, &QDoubleSpinBox::valueChanged, this,
+          &BaseModel::invalidate);
 
   p_sampleNumberSpinBox = new QSpinBox();
   p_sampleNumberSpinBox->setRange(1, INT_MAX);
+  connect(p_sampleNumberSpinBox, &QSpinBox::valueChanged, this,
+          &BaseModel::invalidate);
 
   p_channelNameLineEdit = new QLineEdit();
   p_dateTimeEdit = new QDateTimeEdit();
@@ -42,14 +50,216 @@ void BaseModel::createForm() {
 }
 
 SignalData BaseModel::getData() {
+  update();
+
+  return makeData({p_channelNameLineEdit->text()}, {m_channel});
+}
+
+SignalData BaseModel::makeData(
+    std::vector<QString> &&channelsName,
+    std::vector<std::shared_ptr<const ChannelSource>> &&channels) const {
   int allTime = p_freqSpinBox->value() * p_sampleNumberSpinBox->value() * 1000;
 
   return SignalData(p_dateTimeEdit->dateTime(),
                     p_dateTimeEdit->dateTime().addMSecs(allTime),
                     p_freqSpinBox->value(), 1 / p_freqSpinBox->value(), allTime,
-                    {p_channelNameLineEdit->text()}, {p_data});
+                    std::move(channelsName), std::move(channels));
 }
 
+std::vector<QString> BaseModel::parametersName() const {
+  std::vector<QString> names;
+  for (const Parameter &parameter : m_parameters) {
+    names.push_back(parameter.name);
+  }
+
+  return names;
+}
+
+SignalData BaseModel::getSweepData(
+    const std::vector<std::vector<double>> &values) {
+  std::vector<double> initial;
+  for (const Parameter &parameter : m_parameters) {
+    initial.push_back(parameter.value());
+  }
+
+  std::vector<std::vector<double>> grid(m_parameters.size());
+  for (size_t i = 0; i < m_parameters.size(); ++i) {
+    grid[i] = i < values.size() && !values[i].empty()
+                  ? values[i]
+                  : std::vector<double>{initial[i]};
+  }
+
+  // Генераторы и вычисления захватывают значения параметров, поэтому
+  // сочетания перебираются в потоке окна, а каналы вычисляются параллельно.
+  std::vector<QString> channelsName;
+  std::vector<ProceduralChannel::Generator> generators;
+  std::vector<Computation> computations;
+
+  std::vector<size_t> indices(m_parameters.size(), 0);
+  while (true) {
+    QString suffix;
+    for (size_t i = 0; i < m_parameters.size(); ++i) {
+      m_parameters[i].setValue(grid[i][indices[i]]);
+
+      if (grid[i].size() > 1) {
+        suffix += (suffix.isEmpty() ? "" : ", ") + m_parameters[i].name +
+                  "=" + QString::number(m_parameters[i].value());
+      }
+    }
+
+    QString name = p_channelNameLineEdit->text();
+    if (!suffix.isEmpty()) name += " [" + suffix + "]";
+
+    channelsName.push_back(name);
+    generators.push_back(generator());
+    computations.push_back(generators.back() ? nullptr : computation());
+
+    size_t i = 0;
+    for (; i < indices.size(); ++i) {
+      if (++indices[i] < grid[i].size()) break;
+      indices[i] = 0;
+    }
+
+    if (i == indices.size()) break;
+  }
+
+  for (size_t i = 0; i < m_parameters.size(); ++i) {
+    m_parameters[i].setValue(initial[i]);
+  }
+
+  size_t samplesNumber = p_sampleNumberSpinBox->value();
+
+  std::vector<std::shared_ptr<const ChannelSource>> channels(
+      channelsName.size());
+  parallelFor(0, channels.size(), [&](size_t i) {
+    if (generators[i]) {
+      channels[i] = std::make_shared<ProceduralChannel>(
+          samplesNumber, std::move(generators[i]));
+      return;
+    }
+
+    std::vector<double> data;
+    if (computations[i]) {
+      std::atomic<bool> cancelled{false};
+      data = computations[i](cancelled);
+    }
+
+    channels[i] = std::make_shared<StoredChannel>(std::move(data));
+  });
+
+  return makeData(std::move(channelsName), std::move(channels));
+}
+
+BaseModel::PreviewTask BaseModel::previewTask(int columns) const {
+  QDateTime startTime = p_dateTimeEdit->dateTime();
+  QString name = p_channelNameLineEdit->text();
+  double rate = p_freqSpinBox->value();
+  size_t samplesNumber = p_sampleNumberSpinBox->value();
+  size_t maxSamples = 2 * static_cast<size_t>(columns);
+  int version = m_version;
+
+  ProceduralChannel::Generator channelGenerator = generator();
+  Computation channelComputation = computation();
+
+  // Время берется по полному каналу, чтобы оси совпадали с результатом.
+  int allTime = rate * samplesNumber * 1000;
+
+  auto makeData = [=](std::shared_ptr<const ChannelSource> channel) {
+    double dataRate = rate * channel->size() / samplesNumber;
+
+    return std::make_shared<SignalData>(
+        startTime, startTime.addMSecs(allTime), dataRate, 1 / dataRate,
+        allTime, std::vector<QString>{name},
+        std::vector<std::shared_ptr<const ChannelSource>>{std::move(channel)});
+  };
+
+  return [=](const std::atomic<bool> &cancelled) -> Preview {
+    std::vector<double> data;
+
+    if (channelGenerator && samplesNumber > maxSamples) {
+      // Отсчеты вычисляются по номеру, поэтому достаточно по одному
+      // отсчету на столбец.
+      data = std::vector<double>(columns);
+      for (int i = 0; i < columns; ++i) {
+        if (cancelled) return {};
+
+        size_t sample = samplesNumber * i / columns;
+        channelGenerator(data.data() + i, sample, 1);
+      }
+    } else if (channelGenerator) {
+      data = std::vector<double>(samplesNumber);
+      channelGenerator(data.data(), 0, samplesNumber);
+    } else if (channelComputation) {
+      data = channelComputation(cancelled);
+      if (cancelled || data.empty()) return {};
+
+      // Канал вычислен целиком: он же пойдет в сигнал при добавлении, а
+      // для предпросмотра длинного канала берется его огибающая.
+      std::shared_ptr<const ChannelSource> channel =
+          std::make_shared<StoredChannel>(std::move(data));
+      std::shared_ptr<SignalData> channelData = makeData(channel);
+
+      if (channel->size() > maxSamples) {
+        std::vector<double> envelope =
+            channelData->envelope(0, 0, channel->size(), columns);
+        if (cancelled) return {};
+
+        channelData = makeData(
+            std::make_shared<StoredChannel>(std::move(envelope)));
+      }
+
+      return {channelData, channel, version};
+    }
+
+    if (cancelled || data.empty()) return {};
+
+    return {makeData(std::make_shared<StoredChannel>(std::move(data))),
+            nullptr, version};
+  };
+}
+
+int BaseModel::version() const { return m_version; }
+
+bool BaseModel::setChannel(int version,
+                           std::shared_ptr<const ChannelSource> channel) {
+  if (version != m_version || !channel) return false;
+
+  m_channel = std::move(channel);
+  return true;
+}
+
+bool BaseModel::needsComputation() const { return !m_channel && !generator(); }
+
+void BaseModel::update() {
+  if (m_channel) return;
+
+  if (ProceduralChannel::Generator channelGenerator = generator()) {
+    m_channel = std::make_shared<ProceduralChannel>(
+        p_sampleNumberSpinBox->value(), std::move(channelGenerator));
+    return;
+  }
+
+  std::vector<double> data;
+  if (Computation channelComputation = computation()) {
+    std::atomic<bool> cancelled{false};
+    data = channelComputation(cancelled);
+  }
+
+  m_channel = std::make_shared<StoredChannel>(std::move(data));
+}
+
+void BaseModel::invalidate() {
+  ++m_version;
+  m_channel.reset();
+  emit changed();
+}
+
+ProceduralChannel::Generator BaseModel::generator() const { return nullptr; }
+
+BaseModel::Computation BaseModel::computation() const { return nullptr; }
+
+QString BaseModel::errorString() const { return QString(); }
+
 QDoubleSpinBox *BaseModel::addDoubleSpinBox(const QString name,
                                             const double value,
                                             const double min,
@@ -58,6 +268,15 @@ QDoubleSpinBox *BaseModel::addDoubleSpinBox(const QString name,
   spinBox->setDecimals(8);
   spinBox->setRange(min, max);
   spinBox->setValue(value);
+  connect(spinBox, &QDoubleSpinBox::valueChanged, this,
+          &BaseModel::invalidate);
+
+  m_parameters.push_back({QString(name).remove(':'),
+                          [spinBox]() { return spinBox->value(); },
+                          [spinBox](double value) {
+                            QSignalBlocker blocker(spinBox);
+                            spinBox->setValue(value);
+                          }});
 
   p_formLayout->addRow(name, spinBox);
 
@@ -65,7 +284,12 @@ QDoubleSpinBox *BaseModel::addDoubleSpinBox(const QString name,
 }
 
 QLineEdit *BaseModel::addLineEdit(const QString name, const int value) {
-  QLineEdit *lineEdit = new QLineEdit(QString::number(value));
+  return addLineEdit(name, QString::number(value));
+}
+
+QLineEdit *BaseModel::addLineEdit(const QString name, const QString text) {
+  QLineEdit *lineEdit = new QLineEdit(text);
+  connect(lineEdit, &QLineEdit::textChanged, this, &BaseModel::invalidate);
 
   p_formLayout->addRow(name, lineEdit);
 
@@ -78,6 +302,14 @@ QSpinBox *BaseModel::addSpinBox(const QString name, const int value,
 
   spinBox->setRange(min, max);
   spinBox->setValue(value);
+  connect(spinBox, &QSpinBox::valueChanged, this, &BaseModel::invalidate);
+
+  m_parameters.push_back({QString(name).remove(':'),
+                          [spinBox]() { return spinBox->value(); },
+                          [spinBox](double value) {
+                            QSignalBlocker blocker(spinBox);
+                            spinBox->setValue(std::round(value));
+                          }});
 
   p_formLayout->addRow(name, spinBox);
 
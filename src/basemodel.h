@@ -5,6 +5,7 @@
 #include <QFormLayout>
 #include <QLineEdit>
 #include <QWidget>
+#include <atomic>
 
 #include "signaldata.h"
 
@@ -16,14 +17,72 @@ class BaseModel : public QWidget {
   explicit BaseModel(std::shared_ptr<SignalData> signalData,
                      QWidget *parent = nullptr);
 
+  // Канал модели передается в SignalData без копирования отсчетов.
   SignalData getData();
 
-  virtual void calc() = 0;
+  // Числовые параметры модели, которые можно перебирать.
+  std::vector<QString> parametersName() const;
+
+  // Каналы для всех сочетаний значений параметров (декартово
+  // произведение). values[i] — значения i-го параметра, пустой список
+  // оставляет текущее значение.
+  SignalData getSweepData(const std::vector<std::vector<double>> &values);
+
+  // Пересчитывает модель, только если ее параметры изменились после
+  // предыдущего расчета.
+  void update();
+
+  // Вычисляет все отсчеты канала; при отмене может вернуть их не целиком.
+  typedef std::function<std::vector<double>(const std::atomic<bool> &cancelled)>
+      Computation;
+
+  // Модели, отсчеты которых вычисляются по номеру, возвращают генератор,
+  // и их каналы не хранят отсчеты. Остальные возвращают вычисление всего
+  // канала. И то и другое захватывает копии параметров и может выполняться
+  // в другом потоке.
+  virtual ProceduralChannel::Generator generator() const;
+  virtual Computation computation() const;
+
+  // Описание ошибки в параметрах, из-за которой канал не построить, или
+  // пустая строка.
+  virtual QString errorString() const;
+
+  // Результат предпросмотра: канал не длиннее 2 * columns отсчетов (сами
+  // отсчеты, их прореживание или огибающая). Если для этого пришлось
+  // вычислить канал целиком, он передается в channel вместе с версией
+  // параметров, по которым вычислен.
+  struct Preview {
+    std::shared_ptr<SignalData> data;
+    std::shared_ptr<const ChannelSource> channel;
+    int version = 0;
+  };
+
+  // Задача для предпросмотра. Выполняется в другом потоке, при отмене
+  // возвращает пустой data.
+  typedef std::function<Preview(const std::atomic<bool> &cancelled)>
+      PreviewTask;
+
+  PreviewTask previewTask(int columns) const;
+
+  // Номер набора параметров, увеличивается при каждом изменении.
+  int version() const;
+
+  // Канал, вычисленный в другом потоке по параметрам версии version,
+  // становится каналом модели, если параметры с тех пор не изменились.
+  bool setChannel(int version, std::shared_ptr<const ChannelSource> channel);
+
+  // Нужно ли вычислять канал целиком, прежде чем его добавить: у модели
+  // нет генератора и готового канала.
+  bool needsComputation() const;
 
   void updateChannelName();
 
   void lockHeader();
 
+ signals:
+  // Изменился параметр, от которого зависят отсчеты.
+  void changed();
+
  protected:
   QFormLayout *p_formLayout;
 
@@ -40,8 +99,7 @@ class BaseModel : public QWidget {
                        const int min = INT_MIN, const int max = INT_MAX);
 
   QLineEdit *addLineEdit(const QString name, const int value);
-
-  std::vector<double> p_data;
+  QLineEdit *addLineEdit(const QString name, const QString text);
 
   int number;
   int count;
@@ -49,6 +107,24 @@ class BaseModel : public QWidget {
  private:
   void createFields();
   void createForm();
+
+  void invalidate();
+
+  SignalData makeData(
+      std::vector<QString> &&channelsName,
+      std::vector<std::shared_ptr<const ChannelSource>> &&channels) const;
+
+  std::shared_ptr<const ChannelSource> m_channel;
+  int m_version = 0;
+
+  struct Parameter {
+    QString name;
+    std::function<double()> value;
+    // Устанавливает значение без сигнала об изменении.
+    std::function<void(double)> setValue;
+  };
+
+  std::vector<Parameter> m_parameters;
 };
 
 }  // namespace fssp
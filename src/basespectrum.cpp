@@ -20,10 +20,8 @@ BaseSpectrum::BaseSpectrum(std::shared_ptr<SignalData> signalData, int number,
 
   p_image = QImage();
 
-  p_minValue = *std::min_element(p_signalData->data()[p_number].begin(),
-                                 p_signalData->data()[p_number].end());
-  p_maxValue = *std::max_element(p_signalData->data()[p_number].begin(),
-                                 p_signalData->data()[p_number].end());
+  p_signalData->channelRange(p_number, 0, p_signalData->samplesNumber(),
+                             p_minValue, p_maxValue);
 
   p_leftFreq = 0;
   p_rightFreq = p_signalData->rate() / 2;
@@ -80,21 +78,15 @@ void BaseSpectrum::updateRelative() {
 
   p_freqRange = p_rightFreq - p_leftFreq;
 
-  p_curMinValue =
-      (p_signalData->isGlobalScale())
-          ? p_minValue
-          : *std::min_element(p_signalData->data()[p_number].begin() +
-                                  p_signalData->leftArray(),
-                              p_signalData->data()[p_number].begin() +
-                                  p_signalData->rightArray());
-
-  p_curMaxValue =
-      (p_signalData->isGlobalScale())
-          ? p_maxValue
-          : *std::max_element(p_signalData->data()[p_number].begin() +
-                                  p_signalData->leftArray(),
-                              p_signalData->data()[p_number].begin() +
-                                  p_signalData->rightArray());
+  if (p_signalData->isGlobalScale()) {
+    p_curMinValue = p_minValue;
+    p_curMaxValue = p_maxValue;
+  } else {
+    p_signalData->channelRange(
+        p_number, p_signalData->leftArray(),
+        p_signalData->rightArray() - p_signalData->leftArray(), p_curMinValue,
+        p_curMaxValue);
+  }
 
   p_dataRange = std::abs(p_curMaxValue - p_curMinValue);
 
@@ -428,26 +420,21 @@ void BaseSpectrum::drawBresenham() {
     scale = localHeight / p_dataRange;
   }
 
+  std::vector<double> data = p_signalData->channelData(
+      p_number, p_signalData->leftArray(), p_arrayRange);
+
   for (int i = 0; i < p_arrayRange - 1; ++i) {
     int x1 = std::round(i * localWidth / p_arrayRange) + p_offsetLeft +
              p_paddingLeft;
     int x2 = std::round((i + 1) * localWidth / p_arrayRange) + p_offsetLeft +
              p_paddingLeft;
-    int y1 =
-        localHeight -
-        std::floor(
-            (p_signalData->data()[p_number][i + p_signalData->leftArray()] -
-             p_curMinValue) *
-            scale) +
-        p_offsetTop + p_paddingTop;
-
-    int y2 =
-        localHeight -
-        std::floor(
-            (p_signalData->data()[p_number][i + p_signalData->leftArray() + 1] -
-             p_curMinValue) *
-            scale) +
-        p_offsetTop + p_paddingTop;
+    int y1 = localHeight -
+             std::floor((data[i] - p_curMinValue) * scale) + p_offsetTop +
+             p_paddingTop;
+
+    int y2 = localHeight -
+             std::floor((data[i + 1] - p_curMinValue) * scale) + p_offsetTop +
+             p_paddingTop;
 
     int dx = std::abs(x2 - x1);
     int dy = std::abs(y2 - y1);
@@ -1,11 +1,73 @@
 #include "basewaveform.h"
 
 #include <QPainter>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
+#include "parallel.h"
 #include "qnamespace.h"
+#include "scheduler.h"
 
 namespace fssp {
 
+namespace {
+
+// Отсчеты полосы читаются блоками такой длины.
+constexpr size_t tileBlockSize = 1 << 16;
+
+// Отрезок Брезенхэма, точки вне изображения пропускаются. Концы заранее
+// обрезаны по высоте, поэтому длина отрезка ограничена размером полосы.
+void drawClippedLine(QImage &image, int x1, int y1, int x2, int y2,
+                     QRgb color) {
+  int dx = std::abs(x2 - x1);
+  int dy = std::abs(y2 - y1);
+  int sx = (x1 < x2) ? 1 : -1;
+  int sy = (y1 < y2) ? 1 : -1;
+  int err = dx - dy;
+
+  while (true) {
+    if (x1 >= 0 && x1 < image.width() && y1 >= 0 && y1 < image.height()) {
+      reinterpret_cast<QRgb *>(image.scanLine(y1))[x1] = color;
+    }
+
+    if (x1 == x2 && y1 == y2) break;
+
+    int err2 = 2 * err;
+
+    if (err2 > -dy) {
+      err -= dy;
+      x1 += sx;
+    }
+
+    if (err2 < dx) {
+      err += dx;
+      y1 += sy;
+    }
+  }
+}
+
+// Обрезает отрезок по строкам [top, bottom], false — отрезок целиком вне.
+bool clipRows(double &x1, double &y1, double &x2, double &y2, double top,
+              double bottom) {
+  if (!std::isfinite(y1) || !std::isfinite(y2)) return false;
+  if ((y1 < top && y2 < top) || (y1 > bottom && y2 > bottom)) return false;
+
+  auto clip = [&](double &x, double &y, double row) {
+    x = x1 + (x2 - x1) * (row - y1) / (y2 - y1);
+    y = row;
+  };
+
+  if (y1 < top) clip(x1, y1, top);
+  if (y1 > bottom) clip(x1, y1, bottom);
+  if (y2 < top) clip(x2, y2, top);
+  if (y2 > bottom) clip(x2, y2, bottom);
+
+  return true;
+}
+
+}  // namespace
+
 BaseWaveform::BaseWaveform(std::shared_ptr<SignalData> signalData, int number,
                            int minWidth, int minHeight, QWidget *parent)
     : QLabel{parent} {
@@ -21,6 +83,8 @@ BaseWaveform::BaseWaveform(std::shared_ptr<SignalData> signalData, int number,
   p_image = QImage();
 }
 
+BaseWaveform::~BaseWaveform() { stopRendering(); }
+
 int BaseWaveform::number() const { return p_number; }
 
 void BaseWaveform::setWidth(int width) {
@@ -61,6 +125,80 @@ void BaseWaveform::setTextMargin(int left, int right, int top, int bottom) {
                        p_textMarginLeft + p_textMarginRight;
 }
 
+void BaseWaveform::drawWaveform() {
+  prepareWaveform();
+  renderWaveform();
+  showWaveform();
+}
+
+void BaseWaveform::scheduleWaveform() {
+  if (m_isRendering) {
+    m_isRenderPending = true;
+    return;
+  }
+
+  prepareWaveform();
+
+  // Место под кадр занимается сразу, размеры окон не ждут отрисовки.
+  setMinimumSize(p_width, p_height);
+
+  m_isRendering = true;
+
+  std::shared_ptr<Render> render = m_render;
+  {
+    std::lock_guard<std::mutex> lock(render->mutex);
+    render->running = true;
+  }
+
+  Scheduler::instance().submit(
+      [this, render]() {
+        std::unique_lock<std::mutex> lock(render->mutex);
+
+        bool isRendered = false;
+        if (!render->cancelled) {
+          // Деструктор ждет running, поэтому виджет жив до конца кадра.
+          lock.unlock();
+          try {
+            renderWaveform();
+            isRendered = true;
+          } catch (const std::exception &) {
+          }
+          lock.lock();
+        }
+
+        render->running = false;
+        render->finished.notify_all();
+
+        if (render->cancelled) return;
+
+        QMetaObject::invokeMethod(
+            this, [this, isRendered]() { onWaveformRendered(isRendered); },
+            Qt::QueuedConnection);
+      },
+      Scheduler::Interactive);
+}
+
+void BaseWaveform::onWaveformRendered(bool isRendered) {
+  m_isRendering = false;
+
+  if (isRendered) showWaveform();
+
+  if (!m_isRenderPending) return;
+
+  m_isRenderPending = false;
+  scheduleWaveform();
+}
+
+void BaseWaveform::stopRendering() {
+  std::unique_lock<std::mutex> lock(m_render->mutex);
+  m_render->cancelled = true;
+  m_render->finished.wait(lock, [this]() { return !m_render->running; });
+}
+
+void BaseWaveform::prepareWaveform() {
+  p_name = p_signalData->channelsName()[p_number];
+}
+
 bool BaseWaveform::isImageNull() const { return p_image.isNull(); }
 
 void BaseWaveform::initImage() {
@@ -69,6 +207,24 @@ void BaseWaveform::initImage() {
 
 void BaseWaveform::fill() { p_image.fill(p_fillColor); }
 
+void BaseWaveform::loadEnvelope() {
+  size_t samplesNumber = p_signalData->samplesNumber();
+
+  if (samplesNumber > 2 * static_cast<size_t>(p_envelopeColumns)) {
+    p_data = p_signalData->envelope(p_number, 0, samplesNumber,
+                                    p_envelopeColumns);
+  } else {
+    p_data = p_signalData->channelData(p_number);
+  }
+
+  p_dataOffset = 0;
+
+  p_leftArray = 0;
+  p_rightArray = p_data.size() - 1;
+
+  p_arrayRange = p_data.size();
+}
+
 void BaseWaveform::drawBresenham() {
   if (isImageNull()) throw BaseWaveform::ImageIsNull();
 
@@ -91,10 +247,13 @@ void BaseWaveform::drawBresenham() {
     int x2 = std::round((i + 1) * localWidth / p_arrayRange) + p_offsetLeft +
              p_paddingLeft;
     int y1 = localHeight -
-             std::floor((p_data[i + p_leftArray] - p_minValue) * scale) +
+             std::floor((p_data[i + p_leftArray - p_dataOffset] - p_minValue) *
+                        scale) +
              p_offsetTop + p_paddingTop;
     int y2 = localHeight -
-             std::floor((p_data[i + p_leftArray + 1] - p_minValue) * scale) +
+             std::floor(
+                 (p_data[i + p_leftArray - p_dataOffset + 1] - p_minValue) *
+                 scale) +
              p_offsetTop + p_paddingTop;
 
     int dx = std::abs(x2 - x1);
@@ -131,6 +290,171 @@ void BaseWaveform::drawBresenham() {
   }
 }
 
+void BaseWaveform::drawTrace() {
+  if (isImageNull()) throw BaseWaveform::ImageIsNull();
+
+  if (p_arrayRange <= 0) return;
+
+  std::shared_ptr<const ChannelSource> channel =
+      p_signalData->channel(p_number);
+
+  int localWidth =
+      p_width - (p_offsetLeft + p_offsetRight + p_paddingLeft + p_paddingRight);
+  int localHeight = p_height - (p_offsetTop + p_offsetBottom + p_paddingTop +
+                                p_paddingBottom);
+
+  TileCache::Key key{};
+  key.channel = channel.get();
+  key.range = p_arrayRange;
+  key.width = localWidth;
+  key.height = localHeight;
+  key.minValue = p_minValue;
+  key.maxValue = p_maxValue;
+  key.color = p_graphColor.rgb();
+
+  size_t startColumn = static_cast<size_t>(p_leftArray) * localWidth /
+                       static_cast<size_t>(p_arrayRange);
+
+  long long shift = static_cast<long long>(startColumn) -
+                    static_cast<long long>(m_traceColumn);
+
+  if (!m_trace.isNull() && m_traceKey == key && std::abs(shift) < localWidth) {
+    // Сетка столбцов та же, поэтому сдвинутый слой совпадает с нарисованным
+    // заново, а отрезки через шов рисуют полосы с обеих сторон.
+    int offset = static_cast<int>(shift);
+    int kept = localWidth - std::abs(offset);
+
+    for (int y = 0; y < m_trace.height(); ++y) {
+      QRgb *line = reinterpret_cast<QRgb *>(m_trace.scanLine(y));
+
+      if (offset > 0) {
+        std::memmove(line, line + offset, kept * sizeof(QRgb));
+        std::fill(line + kept, line + localWidth, 0);
+      } else if (offset < 0) {
+        std::memmove(line - offset, line, kept * sizeof(QRgb));
+        std::fill(line, line - offset, 0);
+      }
+    }
+
+    if (offset > 0) {
+      drawTiles(channel, key, startColumn, kept, localWidth);
+    } else if (offset < 0) {
+      drawTiles(channel, key, startColumn, 0, -offset);
+    }
+  } else {
+    m_trace = QImage(localWidth, localHeight + 1, p_imageFormat);
+    m_trace.fill(Qt::transparent);
+
+    drawTiles(channel, key, startColumn, 0, localWidth);
+  }
+
+  m_traceKey = key;
+  m_traceColumn = startColumn;
+
+  QPainter painter(&p_image);
+  painter.drawImage(p_offsetLeft + p_paddingLeft, p_offsetTop + p_paddingTop,
+                    m_trace);
+}
+
+void BaseWaveform::drawTiles(
+    const std::shared_ptr<const ChannelSource> &channel,
+    const TileCache::Key &key, size_t startColumn, int from, int to) {
+  size_t firstTile = (startColumn + from) / TileCache::tileWidth;
+  size_t lastTile = (startColumn + to - 1) / TileCache::tileWidth;
+
+  TileCache &cache = TileCache::instance();
+
+  std::vector<QImage> tiles(lastTile - firstTile + 1);
+  std::vector<size_t> missing;
+  for (size_t i = 0; i < tiles.size(); ++i) {
+    TileCache::Key tileKey = key;
+    tileKey.index = firstTile + i;
+    tiles[i] = cache.find(tileKey);
+
+    if (tiles[i].isNull()) missing.push_back(i);
+  }
+
+  parallelFor(0, missing.size(), [&](size_t j) {
+    TileCache::Key tileKey = key;
+    tileKey.index = firstTile + missing[j];
+
+    tiles[missing[j]] = renderTile(tileKey, *channel);
+    cache.insert(tileKey, channel, tiles[missing[j]]);
+  });
+
+  QPainter painter(&m_trace);
+  painter.setClipRect(from, 0, to - from, m_trace.height());
+
+  for (size_t i = 0; i < tiles.size(); ++i) {
+    int x = static_cast<int>(
+        static_cast<long long>((firstTile + i) * TileCache::tileWidth) -
+        static_cast<long long>(startColumn));
+    painter.drawImage(x, 0, tiles[i]);
+  }
+}
+
+QImage BaseWaveform::renderTile(const TileCache::Key &key,
+                                const ChannelSource &channel) const {
+  QImage tile(TileCache::tileWidth, key.height + 1, p_imageFormat);
+  tile.fill(Qt::transparent);
+
+  size_t firstColumn = key.index * TileCache::tileWidth;
+  size_t lastColumn = firstColumn + TileCache::tileWidth;
+
+  // Отсчеты со столбцами полосы и по соседу с каждой стороны: отрезки
+  // через границу полос рисуются в обеих.
+  size_t first = (firstColumn * key.range + key.width - 1) / key.width;
+  size_t last = (lastColumn * key.range + key.width - 1) / key.width;
+
+  if (first > 0) --first;
+  last = std::min(last + 1, channel.size());
+
+  if (last <= first + 1) return tile;
+
+  double dataRange = key.maxValue - key.minValue;
+  double scale = dataRange == 0 ? key.height / 2 : key.height / dataRange;
+
+  auto column = [&](size_t n) {
+    return static_cast<double>(n * key.width / key.range) -
+           static_cast<double>(firstColumn);
+  };
+  auto row = [&](double value) {
+    return key.height - std::floor((value - key.minValue) * scale);
+  };
+
+  std::vector<double> block(std::min(last - first, tileBlockSize));
+
+  double x1 = 0;
+  double y1 = 0;
+  for (size_t start = first; start < last; start += block.size()) {
+    size_t count = std::min(block.size(), last - start);
+    channel.read(start, count, block.data());
+
+    for (size_t i = 0; i < count; ++i) {
+      double x2 = column(start + i);
+      double y2 = row(block[i]);
+
+      double clippedX1 = x1;
+      double clippedY1 = y1;
+      double clippedX2 = x2;
+      double clippedY2 = y2;
+
+      if (start + i > first &&
+          clipRows(clippedX1, clippedY1, clippedX2, clippedY2, -1,
+                   key.height + 1)) {
+        drawClippedLine(tile, std::round(clippedX1), std::round(clippedY1),
+                        std::round(clippedX2), std::round(clippedY2),
+                        key.color);
+      }
+
+      x1 = x2;
+      y1 = y2;
+    }
+  }
+
+  return tile;
+}
+
 void BaseWaveform::showWaveform() {
   QPixmap pixmap = QPixmap::fromImage(p_image);
   setPixmap(pixmap);
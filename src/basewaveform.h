@@ -5,8 +5,12 @@
 #include <QImage>
 #include <QLabel>
 #include <QWidget>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 
 #include "signaldata.h"
+#include "tilecache.h"
 
 namespace fssp {
 
@@ -16,6 +20,7 @@ class BaseWaveform : public QLabel {
   explicit BaseWaveform(std::shared_ptr<SignalData> signalData, int number,
                         int min_width = 200, int min_height = 50,
                         QWidget *parent = nullptr);
+  ~BaseWaveform();
 
   class ImageIsNull : public std::exception {
    public:
@@ -34,9 +39,27 @@ class BaseWaveform : public QLabel {
 
   void setTextMargin(int left, int right, int top, int bottom);
 
-  virtual void drawWaveform() = 0;
+  // Рисует кадр сразу, в потоке окна.
+  void drawWaveform();
+
+  // Рисует кадр в общем пуле потоков и показывает его, когда он готов.
+  // Пока кадр рисуется, новые запросы только запоминаются: после него
+  // рисуется один кадр по последнему состоянию, промежуточные пропускаются.
+  void scheduleWaveform();
 
  protected:
+  // Переносит в поля кадра состояние, которое меняется в потоке окна.
+  // Вызывается в потоке окна, когда кадр не рисуется.
+  virtual void prepareWaveform();
+
+  // Рисует p_image по полям кадра. Выполняется в рабочем потоке, поэтому не
+  // обращается к виджету и к изменяемым полям SignalData.
+  virtual void renderWaveform() = 0;
+
+  // Отменяет фоновый кадр или дожидается его. Вызывается в деструкторах
+  // наследников: кадр рисуется их методами.
+  void stopRendering();
+
   bool isImageNull() const;
 
   void initImage();
@@ -45,12 +68,26 @@ class BaseWaveform : public QLabel {
 
   void drawBresenham();
 
+  // Рисует трассу [p_leftArray, p_leftArray + p_arrayRange) из полос
+  // TileCache, недостающие полосы рисуются параллельно и попадают в кэш.
+  // Трасса хранится отдельным слоем: при сдвиге вида без смены масштаба
+  // слой прокручивается, и рисуются только открывшиеся столбцы.
+  void drawTrace();
+
   void showWaveform();
 
+  // Читает огибающую всего канала (пары минимум/максимум), если отсчетов
+  // больше, чем имеет смысл рисовать, иначе сами отсчеты.
+  void loadEnvelope();
+
   std::shared_ptr<SignalData> p_signalData;
   int p_number;
 
+  QString p_name;
+
+  // Отсчеты канала, начиная с номера p_dataOffset.
   std::vector<double> p_data;
+  int p_dataOffset = 0;
 
   int p_leftArray;
   int p_rightArray;
@@ -64,7 +101,9 @@ class BaseWaveform : public QLabel {
 
   QImage p_image;
 
-  QImage::Format p_imageFormat = QImage::Format_ARGB32;
+  // Формат пиксмапа растрового движка: кадр из рабочего потока передается
+  // окну без преобразования пикселей.
+  QImage::Format p_imageFormat = QImage::Format_ARGB32_Premultiplied;
   QFont p_font{"Monospace", 10};
 
   QColor p_fillColor{255, 255, 255};
@@ -93,6 +132,8 @@ class BaseWaveform : public QLabel {
 
   int p_maxAxisTextSymbols = 11;
 
+  int p_envelopeColumns = 4096;
+
   int p_textMarginLeft = 0;
   int p_textMarginRight = 0;
   int p_textMarginTop = 0;
@@ -160,6 +201,37 @@ class BaseWaveform : public QLabel {
       311'040'000'000,
       622'080'000'000  // years 37
   };
+
+ private:
+  void onWaveformRendered(bool isRendered);
+
+  // Рисует в m_trace столбцы [from, to) вида, начинающегося со столбца
+  // startColumn сетки масштаба.
+  void drawTiles(const std::shared_ptr<const ChannelSource> &channel,
+                 const TileCache::Key &key, size_t startColumn, int from,
+                 int to);
+
+  QImage renderTile(const TileCache::Key &key,
+                    const ChannelSource &channel) const;
+
+  // Слой трассы последнего кадра, меняется только при отрисовке.
+  QImage m_trace;
+  TileCache::Key m_traceKey{};
+  size_t m_traceColumn = 0;
+
+  // Общее с фоновой задачей состояние, переживает виджет.
+  struct Render {
+    std::mutex mutex;
+    std::condition_variable finished;
+
+    bool running = false;
+    bool cancelled = false;
+  };
+
+  std::shared_ptr<Render> m_render = std::make_shared<Render>();
+
+  bool m_isRendering = false;
+  bool m_isRenderPending = false;
 };
 
 }  // namespace fssp
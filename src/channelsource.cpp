@@ -0,0 +1,194 @@
+#include "channelsource.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "parallel.h"
+
+namespace fssp {
+
+const double *ChannelSource::samples() const { return nullptr; }
+
+void ChannelSource::checkRange(size_t start, size_t count) const {
+  if (start > size() || count > size() - start) {
+    throw ChannelSource::OutOfRange();
+  }
+}
+
+//
+
+StoredChannel::StoredChannel(std::vector<double> data)
+    : m_data{std::move(data)} {}
+
+size_t StoredChannel::size() const { return m_data.size(); }
+
+void StoredChannel::read(size_t start, size_t count, double *output) const {
+  checkRange(start, count);
+
+  std::copy(m_data.begin() + start, m_data.begin() + start + count, output);
+}
+
+const double *StoredChannel::samples() const { return m_data.data(); }
+
+//
+
+ProceduralChannel::ProceduralChannel(size_t size, Generator generator)
+    : m_size{size}, m_generator{std::move(generator)} {}
+
+size_t ProceduralChannel::size() const { return m_size; }
+
+void ProceduralChannel::read(size_t start, size_t count,
+                             double *output) const {
+  checkRange(start, count);
+
+  if (count <= blockSize) {
+    m_generator(output, start, count);
+    return;
+  }
+
+  // Границы блоков выровнены по абсолютному номеру отсчета, чтобы
+  // разбиение не зависело от запрошенного диапазона.
+  size_t end = start + count;
+  size_t first = start / blockSize;
+  size_t last = (end + blockSize - 1) / blockSize;
+
+  parallelFor(first, last, [&](size_t block) {
+    size_t from = std::max(start, block * blockSize);
+    size_t to = std::min(end, (block + 1) * blockSize);
+    m_generator(output + (from - start), from, to - from);
+  });
+}
+
+//
+
+DerivedChannel::DerivedChannel(Operation operation,
+                               std::shared_ptr<const ChannelSource> first,
+                               std::shared_ptr<const ChannelSource> second,
+                               double factor, double rate)
+    : m_operation{operation},
+      m_first{std::move(first)},
+      m_second{std::move(second)},
+      m_factor{factor},
+      m_rate{rate} {
+  m_size = m_first->size();
+
+  if (m_operation == Sum || m_operation == Difference ||
+      m_operation == Product) {
+    if (!m_second) throw DerivedChannel::MissingChannel();
+    m_size = std::min(m_size, m_second->size());
+  }
+}
+
+size_t DerivedChannel::size() const { return m_size; }
+
+void DerivedChannel::read(size_t start, size_t count, double *output) const {
+  checkRange(start, count);
+
+  size_t end = start + count;
+  size_t first = start / blockSize;
+  size_t last = (end + blockSize - 1) / blockSize;
+
+  // Целиком прочитанные блоки (сохранение, спектр, статистика) вычисляются
+  // параллельно без кэша, частично прочитанные берутся из кэша.
+  parallelFor(first, last, [&](size_t index) {
+    size_t from = std::max(start, index * blockSize);
+    size_t to = std::min(end, (index + 1) * blockSize);
+
+    if (from == index * blockSize &&
+        to == std::min(m_size, (index + 1) * blockSize)) {
+      compute(from, to - from, output + (from - start));
+      return;
+    }
+
+    std::shared_ptr<const std::vector<double>> samples = block(index);
+    std::copy(samples->begin() + (from - index * blockSize),
+              samples->begin() + (to - index * blockSize),
+              output + (from - start));
+  });
+}
+
+std::shared_ptr<const std::vector<double>> DerivedChannel::block(
+    size_t index) const {
+  {
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+
+    for (auto it = m_cache.begin(); it != m_cache.end(); ++it) {
+      if (it->first == index) {
+        m_cache.splice(m_cache.begin(), m_cache, it);
+        return it->second;
+      }
+    }
+  }
+
+  size_t start = index * blockSize;
+  size_t count = std::min(blockSize, m_size - start);
+
+  std::shared_ptr<std::vector<double>> samples =
+      std::make_shared<std::vector<double>>(count);
+  compute(start, count, samples->data());
+
+  std::lock_guard<std::mutex> lock(m_cacheMutex);
+
+  m_cache.emplace_front(index, samples);
+  if (m_cache.size() > cacheSize) m_cache.pop_back();
+
+  return samples;
+}
+
+void DerivedChannel::compute(size_t start, size_t count,
+                             double *output) const {
+  if (!count) return;
+
+  switch (m_operation) {
+    case Sum:
+    case Difference:
+    case Product: {
+      std::vector<double> second(count);
+      m_first->read(start, count, output);
+      m_second->read(start, count, second.data());
+
+      if (m_operation == Sum) {
+        for (size_t i = 0; i < count; ++i) output[i] += second[i];
+      } else if (m_operation == Difference) {
+        for (size_t i = 0; i < count; ++i) output[i] -= second[i];
+      } else {
+        for (size_t i = 0; i < count; ++i) output[i] *= second[i];
+      }
+      break;
+    }
+    case Scale:
+      m_first->read(start, count, output);
+      for (size_t i = 0; i < count; ++i) output[i] *= m_factor;
+      break;
+    case Rectify:
+      m_first->read(start, count, output);
+      for (size_t i = 0; i < count; ++i) output[i] = std::abs(output[i]);
+      break;
+    case Derivative: {
+      // Центральная разность, на краях канала односторонняя. Для нее
+      // читается по одному отсчету с каждой стороны диапазона.
+      size_t from = start > 0 ? start - 1 : 0;
+      size_t to = std::min(m_size, start + count + 1);
+
+      std::vector<double> samples(to - from);
+      m_first->read(from, to - from, samples.data());
+
+      if (samples.size() < 2) {
+        output[0] = 0;
+        break;
+      }
+
+      for (size_t i = 0; i < count; ++i) {
+        size_t n = start + i - from;
+        size_t previous = n > 0 ? n - 1 : n;
+        size_t next = n + 1 < samples.size() ? n + 1 : n;
+
+        output[i] = (samples[next] - samples[previous]) * m_rate /
+                    static_cast<double>(next - previous);
+      }
+      break;
+    }
+  }
+}
+
+}  // namespace fssp
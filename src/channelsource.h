@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace fssp {
+
+// Источник отсчетов канала. Отсчеты читаются диапазонами, поэтому канал
+// не обязан хранить их в памяти.
+class ChannelSource {
+ public:
+  virtual ~ChannelSource() = default;
+
+  virtual size_t size() const = 0;
+
+  // Записывает отсчеты [start, start + count) в output.
+  virtual void read(size_t start, size_t count, double *output) const = 0;
+
+  // Отсчеты в памяти, если канал хранит их целиком, иначе nullptr.
+  virtual const double *samples() const;
+
+  class OutOfRange : public std::exception {
+   public:
+    virtual const char *what() const throw() {
+      return "Requested samples are out of the channel range";
+    }
+  };
+
+ protected:
+  void checkRange(size_t start, size_t count) const;
+};
+
+//
+
+class StoredChannel : public ChannelSource {
+ public:
+  explicit StoredChannel(std::vector<double> data);
+
+  size_t size() const override;
+
+  void read(size_t start, size_t count, double *output) const override;
+
+  const double *samples() const override;
+
+ private:
+  std::vector<double> m_data;
+};
+
+//
+
+// Канал модели: хранит только генератор, отсчеты вычисляются при чтении.
+class ProceduralChannel : public ChannelSource {
+ public:
+  // generator(output, start, count) вычисляет отсчеты
+  // [start, start + count) и может вызываться из нескольких потоков.
+  typedef std::function<void(double *output, size_t start, size_t count)>
+      Generator;
+
+  // Длинные диапазоны вычисляются параллельно блоками такой длины.
+  static constexpr size_t blockSize = 1 << 16;
+
+  explicit ProceduralChannel(size_t size, Generator generator);
+
+  size_t size() const override;
+
+  void read(size_t start, size_t count, double *output) const override;
+
+ private:
+  size_t m_size;
+  Generator m_generator;
+};
+
+//
+
+// Канал, вычисляемый из других каналов. Отсчеты вычисляются блоками только
+// для запрошенного диапазона; блоки, прочитанные частично (при отрисовке
+// окна), кэшируются.
+class DerivedChannel : public ChannelSource {
+ public:
+  enum Operation { Sum, Difference, Product, Scale, Rectify, Derivative };
+
+  static constexpr size_t blockSize = 1 << 14;
+  static constexpr size_t cacheSize = 16;
+
+  // Sum, Difference и Product используют оба канала, остальные только
+  // первый. factor — множитель для Scale, rate — частота дискретизации для
+  // Derivative.
+  explicit DerivedChannel(Operation operation,
+                          std::shared_ptr<const ChannelSource> first,
+                          std::shared_ptr<const ChannelSource> second,
+                          double factor = 1, double rate = 1);
+
+  size_t size() const override;
+
+  void read(size_t start, size_t count, double *output) const override;
+
+  class MissingChannel : public std::exception {
+   public:
+    virtual const char *what() const throw() {
+      return "Derived channel operation needs a second channel";
+    }
+  };
+
+ private:
+  void compute(size_t start, size_t count, double *output) const;
+
+  std::shared_ptr<const std::vector<double>> block(size_t index) const;
+
+  Operation m_operation;
+  std::shared_ptr<const ChannelSource> m_first;
+  std::shared_ptr<const ChannelSource> m_second;
+  double m_factor;
+  double m_rate;
+
+  size_t m_size;
+
+  // Недавно использованные блоки, последний использованный в начале.
+  mutable std::mutex m_cacheMutex;
+  mutable std::list<
+      std::pair<size_t, std::shared_ptr<const std::vector<double>>>>
+      m_cache;
+};
+
+}  // namespace fssp
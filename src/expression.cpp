@@ -0,0 +1,521 @@
+#include "expression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <locale>
+#include <memory>
+#include <sstream>
+
+namespace fssp {
+
+struct Expression::Node {
+  Operation operation = Index;
+
+  bool constant = false;
+  double value = 0;
+
+  size_t input = 0;
+
+  std::unique_ptr<Node> a;
+  std::unique_ptr<Node> b;
+};
+
+//
+
+// Разбор рекурсивным спуском. Подвыражения из констант вычисляются сразу.
+class Expression::Parser {
+ public:
+  Parser(const std::string &text, const std::vector<std::string> &inputs,
+         double rate)
+      : m_text(text), m_inputs(inputs), m_rate(rate) {}
+
+  std::unique_ptr<Node> parse() {
+    std::unique_ptr<Node> node = parseSum();
+
+    skipSpaces();
+    if (m_position != m_text.size()) throw Expression::SyntaxError();
+
+    return node;
+  }
+
+ private:
+  std::unique_ptr<Node> parseSum() {
+    std::unique_ptr<Node> node = parseProduct();
+
+    while (true) {
+      if (accept('+')) {
+        node = binary(Add, std::move(node), parseProduct());
+      } else if (accept('-')) {
+        node = binary(Subtract, std::move(node), parseProduct());
+      } else {
+        return node;
+      }
+    }
+  }
+
+  std::unique_ptr<Node> parseProduct() {
+    std::unique_ptr<Node> node = parseUnary();
+
+    while (true) {
+      if (accept('*')) {
+        node = binary(Multiply, std::move(node), parseUnary());
+      } else if (accept('/')) {
+        node = binary(Divide, std::move(node), parseUnary());
+      } else if (accept('%')) {
+        node = binary(Modulo, std::move(node), parseUnary());
+      } else {
+        return node;
+      }
+    }
+  }
+
+  // Унарный минус связывает слабее степени: -x^2 = -(x^2).
+  std::unique_ptr<Node> parseUnary() {
+    if (accept('-')) return unary(Negate, parseUnary());
+    if (accept('+')) return parseUnary();
+
+    return parsePower();
+  }
+
+  std::unique_ptr<Node> parsePower() {
+    std::unique_ptr<Node> node = parsePrimary();
+
+    if (acceptPower()) return binary(Power, std::move(node), parseUnary());
+
+    return node;
+  }
+
+  std::unique_ptr<Node> parsePrimary() {
+    skipSpaces();
+    if (m_position == m_text.size()) throw Expression::SyntaxError();
+
+    if (accept('(')) {
+      std::unique_ptr<Node> node = parseSum();
+      if (!accept(')')) throw Expression::SyntaxError();
+      return node;
+    }
+
+    char symbol = m_text[m_position];
+    if (std::isdigit(static_cast<unsigned char>(symbol)) || symbol == '.') {
+      return constant(parseNumber());
+    }
+
+    if (std::isalpha(static_cast<unsigned char>(symbol)) || symbol == '_') {
+      return parseName();
+    }
+
+    throw Expression::SyntaxError();
+  }
+
+  double parseNumber() {
+    size_t begin = m_position;
+
+    auto digits = [&]() {
+      while (m_position < m_text.size() &&
+             std::isdigit(static_cast<unsigned char>(m_text[m_position]))) {
+        ++m_position;
+      }
+    };
+
+    digits();
+    if (m_position < m_text.size() && m_text[m_position] == '.') {
+      ++m_position;
+      digits();
+    }
+
+    if (m_position < m_text.size() &&
+        (m_text[m_position] == 'e' || m_text[m_position] == 'E')) {
+      size_t mantissaEnd = m_position++;
+      if (m_position < m_text.size() &&
+          (m_text[m_position] == '+' || m_text[m_position] == '-')) {
+        ++m_position;
+      }
+
+      size_t exponentBegin = m_position;
+      digits();
+      if (m_position == exponentBegin) m_position = mantissaEnd;
+    }
+
+    // Разбор не зависит от локали приложения.
+    std::istringstream stream(m_text.substr(begin, m_position - begin));
+    stream.imbue(std::locale::classic());
+
+    double value;
+    if (!(stream >> value)) throw Expression::SyntaxError();
+
+    return value;
+  }
+
+  std::unique_ptr<Node> parseName() {
+    size_t begin = m_position;
+    while (m_position < m_text.size() &&
+           (std::isalnum(static_cast<unsigned char>(m_text[m_position])) ||
+            m_text[m_position] == '_')) {
+      ++m_position;
+    }
+
+    std::string name = m_text.substr(begin, m_position - begin);
+
+    if (accept('(')) return parseFunction(name);
+
+    auto input = std::find(m_inputs.begin(), m_inputs.end(), name);
+    if (input != m_inputs.end()) {
+      return leaf(Input, input - m_inputs.begin());
+    }
+
+    if (name == "n") return leaf(Index);
+    if (name == "t") return leaf(Time);
+    if (name == "fs") return constant(m_rate);
+    if (name == "pi") return constant(M_PI);
+    if (name == "e") return constant(M_E);
+
+    // Каналы также доступны по номеру: ch1, ch2, ...
+    if (name.size() > 2 && name.compare(0, 2, "ch") == 0 &&
+        std::all_of(name.begin() + 2, name.end(), [](char symbol) {
+          return std::isdigit(static_cast<unsigned char>(symbol));
+        })) {
+      size_t number = std::stoul(name.substr(2));
+      if (number >= 1 && number <= m_inputs.size()) {
+        return leaf(Input, number - 1);
+      }
+    }
+
+    throw Expression::UnknownName();
+  }
+
+  std::unique_ptr<Node> parseFunction(const std::string &name) {
+    struct Function {
+      const char *name;
+      Operation operation;
+      int arity;
+    };
+
+    static const Function functions[] = {
+        {"sin", Sin, 1},     {"cos", Cos, 1},     {"tan", Tan, 1},
+        {"asin", Asin, 1},   {"acos", Acos, 1},   {"atan", Atan, 1},
+        {"sinh", Sinh, 1},   {"cosh", Cosh, 1},   {"tanh", Tanh, 1},
+        {"exp", Exp, 1},     {"log", Log, 1},     {"ln", Log, 1},
+        {"log10", Log10, 1}, {"sqrt", Sqrt, 1},   {"abs", Abs, 1},
+        {"floor", Floor, 1}, {"ceil", Ceil, 1},   {"round", Round, 1},
+        {"sign", Sign, 1},   {"pow", Power, 2},   {"min", Min, 2},
+        {"max", Max, 2},     {"atan2", Atan2, 2}, {"mod", Modulo, 2}};
+
+    const Function *function =
+        std::find_if(std::begin(functions), std::end(functions),
+                     [&](const Function &f) { return name == f.name; });
+    if (function == std::end(functions)) throw Expression::UnknownName();
+
+    std::vector<std::unique_ptr<Node>> arguments;
+    if (!accept(')')) {
+      do {
+        arguments.push_back(parseSum());
+      } while (accept(','));
+
+      if (!accept(')')) throw Expression::SyntaxError();
+    }
+
+    if (static_cast<int>(arguments.size()) != function->arity) {
+      throw Expression::WrongArgumentsNumber();
+    }
+
+    if (function->arity == 1) {
+      return unary(function->operation, std::move(arguments[0]));
+    }
+
+    return binary(function->operation, std::move(arguments[0]),
+                  std::move(arguments[1]));
+  }
+
+  void skipSpaces() {
+    while (m_position < m_text.size() &&
+           std::isspace(static_cast<unsigned char>(m_text[m_position]))) {
+      ++m_position;
+    }
+  }
+
+  bool accept(char symbol) {
+    skipSpaces();
+    if (m_position < m_text.size() && m_text[m_position] == symbol) {
+      ++m_position;
+      return true;
+    }
+
+    return false;
+  }
+
+  bool acceptPower() {
+    if (accept('^')) return true;
+
+    skipSpaces();
+    if (m_text.compare(m_position, 2, "**") == 0) {
+      m_position += 2;
+      return true;
+    }
+
+    return false;
+  }
+
+  static std::unique_ptr<Node> constant(double value) {
+    std::unique_ptr<Node> node = std::make_unique<Node>();
+    node->constant = true;
+    node->value = value;
+    return node;
+  }
+
+  static std::unique_ptr<Node> leaf(Operation operation, size_t input = 0) {
+    std::unique_ptr<Node> node = std::make_unique<Node>();
+    node->operation = operation;
+    node->input = input;
+    return node;
+  }
+
+  static std::unique_ptr<Node> unary(Operation operation,
+                                     std::unique_ptr<Node> a) {
+    if (a->constant) {
+      double value = a->value;
+      Expression::visit(operation, [&](auto function) {
+        value = function(value, 0.);
+      });
+      return constant(value);
+    }
+
+    std::unique_ptr<Node> node = leaf(operation);
+    node->a = std::move(a);
+    return node;
+  }
+
+  static std::unique_ptr<Node> binary(Operation operation,
+                                      std::unique_ptr<Node> a,
+                                      std::unique_ptr<Node> b) {
+    if (a->constant && b->constant) {
+      double value = 0;
+      Expression::visit(operation, [&](auto function) {
+        value = function(a->value, b->value);
+      });
+      return constant(value);
+    }
+
+    // Частные случаи, для которых есть более быстрые команды.
+    if (operation == Power && b->constant) {
+      if (b->value == 1) return a;
+      if (b->value == 2) return unary(Square, std::move(a));
+      if (b->value == 0.5) return unary(Sqrt, std::move(a));
+    }
+
+    if (operation == Divide && b->constant && b->value != 0) {
+      operation = Multiply;
+      b->value = 1 / b->value;
+    }
+
+    std::unique_ptr<Node> node = leaf(operation);
+    node->a = std::move(a);
+    node->b = std::move(b);
+    return node;
+  }
+
+  const std::string &m_text;
+  const std::vector<std::string> &m_inputs;
+  double m_rate;
+
+  size_t m_position = 0;
+};
+
+//
+
+Expression::Expression(const std::string &text,
+                       const std::vector<std::string> &inputs, double rate) {
+  m_rate = rate;
+
+  std::unique_ptr<Node> root = Parser(text, inputs, rate).parse();
+
+  std::vector<int> freeRegisters;
+  m_result = compile(*root, freeRegisters);
+
+  std::sort(m_usedInputs.begin(), m_usedInputs.end());
+  m_usedInputs.erase(std::unique(m_usedInputs.begin(), m_usedInputs.end()),
+                     m_usedInputs.end());
+}
+
+const std::vector<size_t> &Expression::usedInputs() const {
+  return m_usedInputs;
+}
+
+int Expression::allocate(std::vector<int> &freeRegisters) {
+  if (freeRegisters.empty()) return m_registersNumber++;
+
+  int reg = freeRegisters.back();
+  freeRegisters.pop_back();
+  return reg;
+}
+
+Expression::Operand Expression::compile(const Node &node,
+                                        std::vector<int> &freeRegisters) {
+  Operand result;
+
+  if (node.constant) {
+    result.value = node.value;
+    return result;
+  }
+
+  Instruction instruction{node.operation, -1, Operand(), Operand(), 0};
+
+  if (!node.a) {
+    result.reg = allocate(freeRegisters);
+
+    instruction.input = node.input;
+    if (node.operation == Input) m_usedInputs.push_back(node.input);
+  } else {
+    instruction.a = compile(*node.a, freeRegisters);
+    if (node.b) instruction.b = compile(*node.b, freeRegisters);
+
+    // Результат пишется на место одного из аргументов, второй регистр
+    // освобождается.
+    if (!instruction.a.isConstant()) {
+      result.reg = instruction.a.reg;
+      if (!instruction.b.isConstant()) {
+        freeRegisters.push_back(instruction.b.reg);
+      }
+    } else {
+      result.reg = instruction.b.reg;
+    }
+  }
+
+  instruction.destination = result.reg;
+  m_instructions.push_back(instruction);
+
+  return result;
+}
+
+template <typename Visitor>
+void Expression::visit(Operation operation, Visitor visitor) {
+  switch (operation) {
+    case Negate:
+      return visitor([](double x, double) { return -x; });
+    case Square:
+      return visitor([](double x, double) { return x * x; });
+    case Sin:
+      return visitor([](double x, double) { return std::sin(x); });
+    case Cos:
+      return visitor([](double x, double) { return std::cos(x); });
+    case Tan:
+      return visitor([](double x, double) { return std::tan(x); });
+    case Asin:
+      return visitor([](double x, double) { return std::asin(x); });
+    case Acos:
+      return visitor([](double x, double) { return std::acos(x); });
+    case Atan:
+      return visitor([](double x, double) { return std::atan(x); });
+    case Sinh:
+      return visitor([](double x, double) { return std::sinh(x); });
+    case Cosh:
+      return visitor([](double x, double) { return std::cosh(x); });
+    case Tanh:
+      return visitor([](double x, double) { return std::tanh(x); });
+    case Exp:
+      return visitor([](double x, double) { return std::exp(x); });
+    case Log:
+      return visitor([](double x, double) { return std::log(x); });
+    case Log10:
+      return visitor([](double x, double) { return std::log10(x); });
+    case Sqrt:
+      return visitor([](double x, double) { return std::sqrt(x); });
+    case Abs:
+      return visitor([](double x, double) { return std::abs(x); });
+    case Floor:
+      return visitor([](double x, double) { return std::floor(x); });
+    case Ceil:
+      return visitor([](double x, double) { return std::ceil(x); });
+    case Round:
+      return visitor([](double x, double) { return std::round(x); });
+    case Sign:
+      return visitor([](double x, double) {
+        return static_cast<double>((x > 0) - (x < 0));
+      });
+    case Add:
+      return visitor([](double x, double y) { return x + y; });
+    case Subtract:
+      return visitor([](double x, double y) { return x - y; });
+    case Multiply:
+      return visitor([](double x, double y) { return x * y; });
+    case Divide:
+      return visitor([](double x, double y) { return x / y; });
+    case Modulo:
+      return visitor([](double x, double y) { return std::fmod(x, y); });
+    case Power:
+      return visitor([](double x, double y) { return std::pow(x, y); });
+    case Min:
+      return visitor([](double x, double y) { return std::min(x, y); });
+    case Max:
+      return visitor([](double x, double y) { return std::max(x, y); });
+    case Atan2:
+      return visitor([](double x, double y) { return std::atan2(x, y); });
+    default:
+      return;
+  }
+}
+
+template <typename Function>
+void Expression::run(Function function, double *output, const Operand &a,
+                     const Operand &b, const double *registers, size_t count) {
+  // Отдельные циклы для константных операндов, чтобы компилятор
+  // векторизовал простые операции.
+  if (a.isConstant()) {
+    const double *y = registers + b.reg * blockSize;
+    for (size_t i = 0; i < count; ++i) output[i] = function(a.value, y[i]);
+  } else if (b.isConstant()) {
+    const double *x = registers + a.reg * blockSize;
+    for (size_t i = 0; i < count; ++i) output[i] = function(x[i], b.value);
+  } else {
+    const double *x = registers + a.reg * blockSize;
+    const double *y = registers + b.reg * blockSize;
+    for (size_t i = 0; i < count; ++i) output[i] = function(x[i], y[i]);
+  }
+}
+
+void Expression::evaluate(double *output, size_t start, size_t count,
+                          const InputReader &reader) const {
+  if (m_result.isConstant()) {
+    std::fill(output, output + count, m_result.value);
+    return;
+  }
+
+  std::vector<double> registers(m_registersNumber * blockSize);
+
+  for (size_t offset = 0; offset < count; offset += blockSize) {
+    size_t first = start + offset;
+    size_t length = std::min(blockSize, count - offset);
+
+    for (const Instruction &instruction : m_instructions) {
+      double *destination =
+          registers.data() + instruction.destination * blockSize;
+
+      switch (instruction.operation) {
+        case Index:
+          for (size_t i = 0; i < length; ++i) {
+            destination[i] = static_cast<double>(first + i);
+          }
+          break;
+        case Time:
+          for (size_t i = 0; i < length; ++i) {
+            destination[i] = static_cast<double>(first + i) / m_rate;
+          }
+          break;
+        case Input:
+          reader(instruction.input, destination, first, length);
+          break;
+        default:
+          visit(instruction.operation, [&](auto function) {
+            run(function, destination, instruction.a, instruction.b,
+                registers.data(), length);
+          });
+          break;
+      }
+    }
+
+    const double *result = registers.data() + m_result.reg * blockSize;
+    std::copy(result, result + length, output + offset);
+  }
+}
+
+}  // namespace fssp
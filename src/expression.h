@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace fssp {
+
+// Выражение над номером отсчета n, временем t = n / fs, частотой
+// дискретизации fs и входными каналами, например
+// "0.5*sin(2*pi*50*t) + ch3*exp(-t/2)". Выражение компилируется один раз
+// в регистровый байт-код, команды которого обрабатывают сразу блок
+// отсчетов.
+class Expression {
+ public:
+  // Команды выполняются над блоками такой длины.
+  static constexpr size_t blockSize = 1024;
+
+  // reader(input, output, start, count) записывает отсчеты
+  // [start, start + count) входа с номером input, может вызываться из
+  // нескольких потоков.
+  typedef std::function<void(size_t input, double *output, size_t start,
+                             size_t count)>
+      InputReader;
+
+  // inputs — имена входов в порядке их номеров.
+  explicit Expression(const std::string &text,
+                      const std::vector<std::string> &inputs, double rate);
+
+  // Вычисляет отсчеты [start, start + count). Выражение не изменяется,
+  // поэтому его можно вычислять из нескольких потоков.
+  void evaluate(double *output, size_t start, size_t count,
+                const InputReader &reader) const;
+
+  // Номера входов, которые встречаются в выражении.
+  const std::vector<size_t> &usedInputs() const;
+
+  class SyntaxError : public std::exception {
+   public:
+    virtual const char *what() const throw() {
+      return "Expression syntax error";
+    }
+  };
+
+  class UnknownName : public std::exception {
+   public:
+    virtual const char *what() const throw() {
+      return "Unknown variable or function in expression";
+    }
+  };
+
+  class WrongArgumentsNumber : public std::exception {
+   public:
+    virtual const char *what() const throw() {
+      return "Wrong number of function arguments in expression";
+    }
+  };
+
+ private:
+  enum Operation {
+    Index,
+    Time,
+    Input,
+
+    Negate,
+    Square,
+    Sin,
+    Cos,
+    Tan,
+    Asin,
+    Acos,
+    Atan,
+    Sinh,
+    Cosh,
+    Tanh,
+    Exp,
+    Log,
+    Log10,
+    Sqrt,
+    Abs,
+    Floor,
+    Ceil,
+    Round,
+    Sign,
+
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Modulo,
+    Power,
+    Min,
+    Max,
+    Atan2
+  };
+
+  // Операнд команды: регистр или константа.
+  struct Operand {
+    int reg = -1;
+    double value = 0;
+
+    bool isConstant() const { return reg < 0; }
+  };
+
+  struct Instruction {
+    Operation operation;
+    int destination;
+    Operand a;
+    Operand b;
+    size_t input;
+  };
+
+  class Parser;
+  struct Node;
+
+  // Вызывает visitor с функцией двух аргументов, выполняющей операцию.
+  template <typename Visitor>
+  static void visit(Operation operation, Visitor visitor);
+
+  template <typename Function>
+  static void run(Function function, double *output, const Operand &a,
+                  const Operand &b, const double *registers, size_t count);
+
+  Operand compile(const Node &node, std::vector<int> &freeRegisters);
+  int allocate(std::vector<int> &freeRegisters);
+
+  double m_rate;
+
+  std::vector<Instruction> m_instructions;
+  int m_registersNumber = 0;
+
+  Operand m_result;
+
+  std::vector<size_t> m_usedInputs;
+};
+
+}  // namespace fssp
@@ -0,0 +1,62 @@
+#include "fft.h"
+
+#include <cmath>
+#include <utility>
+
+namespace fssp {
+
+void fft(std::vector<std::complex<double>> &a, bool invert) {
+  typedef std::complex<double> base;
+
+  int n = a.size();
+
+  for (int i = 1, j = 0; i < n; ++i) {
+    int bit = n >> 1;
+    for (; j >= bit; bit >>= 1) j -= bit;
+    j += bit;
+    if (i < j) std::swap(a[i], a[j]);
+  }
+
+  // Поворачивающие множители для полной длины; каждый собирается из
+  // двух табличных, посчитанных напрямую, поэтому ошибка не растет с
+  // длиной, а синусов нужно порядка sqrt(n).
+  int half = n / 2;
+  int step = 1;
+  while (step * step < half) step *= 2;
+
+  double ang = 2 * M_PI / n * (invert ? -1 : 1);
+
+  int coarseSize = (half + step - 1) / step;
+
+  std::vector<base> fine(step), coarse(coarseSize);
+  for (int j = 0; j < step; ++j) {
+    fine[j] = base(cos(ang * j), sin(ang * j));
+  }
+  for (int j = 0; j < coarseSize; ++j) {
+    coarse[j] = base(cos(ang * j * step), sin(ang * j * step));
+  }
+
+  std::vector<base> roots(half);
+  for (int j = 0; j < half; ++j) {
+    roots[j] = coarse[j / step] * fine[j % step];
+  }
+
+  for (int len = 2; len <= n; len <<= 1) {
+    int stride = n / len;
+    for (int i = 0; i < n; i += len) {
+      for (int j = 0; j < len / 2; ++j) {
+        base u = a[i + j];
+        base x = a[i + j + len / 2];
+        base w = roots[j * stride];
+        base v(x.real() * w.real() - x.imag() * w.imag(),
+               x.real() * w.imag() + x.imag() * w.real());
+        a[i + j] = u + v;
+        a[i + j + len / 2] = u - v;
+      }
+    }
+  }
+  if (invert)
+    for (int i = 0; i < n; ++i) a[i] /= n;
+}
+
+}  // namespace fssp
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <complex>
+#include <vector>
+
+namespace fssp {
+
+// Быстрое преобразование Фурье по основанию 2 на месте.
+// Размер a должен быть степенью двойки.
+void fft(std::vector<std::complex<double>> &a, bool invert);
+
+}  // namespace fssp
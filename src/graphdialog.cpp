@@ -99,17 +99,19 @@ void GraphDialog::drawWaveforms() {
       m_waveforms[i]->setMiddle();
     }
 
-    m_waveforms[i]->drawWaveform();
     m_waveforms[i]->show();
 
     last = i;
     ++count;
   }
 
-  if (count <= 1) return;
+  if (count > 1) m_waveforms[last]->setBottom();
 
-  m_waveforms[last]->setBottom();
-  m_waveforms[last]->drawWaveform();
+  // Кадры каналов рисуются параллельно в общем пуле потоков и появляются
+  // по мере готовности.
+  for (int i = 0; i < m_waveforms.size(); ++i) {
+    if (m_signalData->visibleWaveforms()[i]) m_waveforms[i]->scheduleWaveform();
+  }
 }
 
 void GraphDialog::hideWaveforms() {
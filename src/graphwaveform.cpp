@@ -1,5 +1,7 @@
 #include "graphwaveform.h"
 
+#include <algorithm>
+
 namespace fssp {
 
 GraphWaveform::GraphWaveform(std::shared_ptr<SignalData> signalData, int number,
@@ -18,8 +20,7 @@ GraphWaveform::GraphWaveform(std::shared_ptr<SignalData> signalData, int number,
             10, 10);
   setPadding(3, 3, 3, 3);
 
-  p_data = p_signalData->data()[p_number];
-
+  updateValueRange();
   updateRelative();
 
   connect(p_signalData.get(), &SignalData::changedEnableGrid, this,
@@ -34,7 +35,25 @@ GraphWaveform::GraphWaveform(std::shared_ptr<SignalData> signalData, int number,
   setFocusPolicy(Qt::StrongFocus);
 }
 
-void GraphWaveform::drawWaveform() {
+GraphWaveform::~GraphWaveform() { stopRendering(); }
+
+void GraphWaveform::prepareWaveform() {
+  BaseWaveform::prepareWaveform();
+
+  m_isTop = m_position == Top;
+  m_isBottom = m_position == Bottom;
+
+  setOffset(p_offsetLeft, p_offsetRight, m_isTop ? p_maxTextHeight + 5 : 10,
+            m_isBottom ? p_maxTextHeight + 5 : 10);
+
+  // Во время сдвига вида масштаб по вертикали не меняется, поэтому кадры
+  // собираются прокруткой слоя трассы.
+  if (!p_signalData->isPanning()) updateValueRange();
+
+  updateRelative();
+}
+
+void GraphWaveform::renderWaveform() {
   initImage();
   fill();
   drawName();
@@ -47,9 +66,7 @@ void GraphWaveform::drawWaveform() {
   }
 
   drawGrid();
-  drawBresenham();
-
-  showWaveform();
+  drawTrace();
 }
 
 void GraphWaveform::updateRelative() {
@@ -58,17 +75,8 @@ void GraphWaveform::updateRelative() {
 
   p_arrayRange = p_rightArray - p_leftArray + 1;
 
-  if (p_signalData->isGlobalScale()) {
-    p_maxValue = *std::max_element(p_data.begin(), p_data.end());
-    p_minValue = *std::min_element(p_data.begin(), p_data.end());
-  } else {
-    p_maxValue = *std::max_element(p_data.begin() + p_leftArray,
-                                   p_data.begin() + p_rightArray);
-    p_minValue = *std::min_element(p_data.begin() + p_leftArray,
-                                   p_data.begin() + p_rightArray);
-  }
-
-  p_dataRange = std::abs(p_maxValue - p_minValue);
+  m_timeRange = p_signalData->timeRange();
+  m_isGridEnabled = p_signalData->isGridEnabled();
 
   p_xLabelsNumber = ((p_height - (p_offsetBottom + p_paddingBottom)) -
                      (p_offsetTop + p_paddingTop)) /
@@ -84,38 +92,41 @@ void GraphWaveform::updateRelative() {
 
   m_pixelPerTime = ((p_width - (p_offsetRight + p_paddingRight)) -
                     (p_offsetLeft + p_paddingLeft)) /
-                   static_cast<double>(p_signalData->timeRange());
+                   static_cast<double>(m_timeRange);
 
   m_dataPerPixel = 1 / m_pixelPerData;
 
   m_timePerPixel = 1 / m_pixelPerTime;
 }
 
-void GraphWaveform::setTop() {
-  m_isTop = true;
-  m_isBottom = false;
+void GraphWaveform::updateValueRange() {
+  if (p_signalData->isGlobalScale()) {
+    p_signalData->channelRange(p_number, 0, p_signalData->samplesNumber(),
+                               p_minValue, p_maxValue);
+  } else {
+    p_signalData->channelRange(
+        p_number, p_signalData->leftArray(),
+        p_signalData->rightArray() - p_signalData->leftArray(), p_minValue,
+        p_maxValue);
+  }
 
-  setOffset(p_offsetLeft, p_offsetRight, p_maxTextHeight + 5, 10);
-  updateRelative();
+  p_dataRange = std::abs(p_maxValue - p_minValue);
 }
 
-void GraphWaveform::setMiddle() {
-  m_isTop = false;
-  m_isBottom = false;
-
-  setOffset(p_offsetLeft, p_offsetRight, 10, 10);
-  updateRelative();
-}
+void GraphWaveform::setTop() { m_position = Top; }
 
-void GraphWaveform::setBottom() {
-  m_isTop = false;
-  m_isBottom = true;
+void GraphWaveform::setMiddle() { m_position = Middle; }
 
-  setOffset(p_offsetLeft, p_offsetRight, 10, p_maxTextHeight + 5);
-  updateRelative();
-}
+void GraphWaveform::setBottom() { m_position = Bottom; }
 
 void GraphWaveform::mousePressEvent(QMouseEvent *event) {
+  if (event->button() == Qt::MiddleButton) {
+    m_isDragging = true;
+    m_dragStartX = event->pos().x();
+    m_dragStartArray = p_signalData->leftArray();
+    return;
+  }
+
   if (event->button() != Qt::LeftButton) return;
 
   if (m_isCtrlPressed) {
@@ -127,6 +138,16 @@ void GraphWaveform::mousePressEvent(QMouseEvent *event) {
 }
 
 void GraphWaveform::mouseMoveEvent(QMouseEvent *event) {
+  if (m_isDragging) {
+    int localWidth = p_width - (p_offsetLeft + p_paddingLeft + p_offsetRight +
+                                p_paddingRight);
+    double arrayPerPixel = p_arrayRange / static_cast<double>(localWidth);
+
+    int shift = std::round((event->pos().x() - m_dragStartX) * arrayPerPixel);
+    pan(m_dragStartArray - shift - p_signalData->leftArray());
+    return;
+  }
+
   if (m_isCtrlPressed) {
     showToolTip(event);
     return;
@@ -151,9 +172,36 @@ void GraphWaveform::mouseMoveEvent(QMouseEvent *event) {
                         : QRect(m_startPoint, currentPos);
 
   update();
+
+  // Диапазон отсчетов под выделением, без изменения текущего диапазона
+  double leftTime = p_signalData->leftTime() +
+                    std::abs(m_selectionRect.topLeft().x() -
+                             (p_offsetLeft + p_paddingLeft)) *
+                        m_timePerPixel;
+  double rightTime = p_signalData->leftTime() +
+                     std::abs(m_selectionRect.bottomRight().x() -
+                              (p_offsetLeft + p_paddingLeft)) *
+                         m_timePerPixel;
+
+  size_t samplesNumber = p_signalData->samplesNumber();
+  double dataPerTime = static_cast<double>(samplesNumber) /
+                       static_cast<double>(p_signalData->allTime());
+
+  size_t leftArray = std::min<size_t>(dataPerTime * leftTime, samplesNumber);
+  size_t rightArray = std::min<size_t>(dataPerTime * rightTime, samplesNumber);
+
+  if (rightArray > leftArray) {
+    emit p_signalData->changingGraphTimeRange(leftArray, rightArray);
+  }
 }
 
 void GraphWaveform::mouseReleaseEvent(QMouseEvent *event) {
+  if (event->button() == Qt::MiddleButton && m_isDragging) {
+    m_isDragging = false;
+    finishPanning();
+    return;
+  }
+
   if (event->button() == Qt::LeftButton && m_isSelected &&
       !m_selectionRect.isNull()) {
     m_isSelected = false;
@@ -171,14 +219,12 @@ void GraphWaveform::mouseReleaseEvent(QMouseEvent *event) {
     p_signalData->calculateArrayRange();
     p_signalData->setSelected(true);
 
-    updateRelative();
-
     emit p_signalData->changedGraphTimeRange();
   }
 
   if (m_isToolTipShow) {
     m_isToolTipShow = false;
-    drawWaveform();
+    update();
   }
 }
 
@@ -212,18 +258,46 @@ void GraphWaveform::keyPressEvent(QKeyEvent *event) {
     m_isCtrlPressed = true;
     m_isSelected = false;
   }
+
+  // Стрелки сдвигают вид на десятую часть.
+  if (event->key() == Qt::Key_Left || event->key() == Qt::Key_Right) {
+    int step = std::max(1, p_arrayRange / 10);
+    pan(event->key() == Qt::Key_Left ? -step : step);
+  }
 }
 
 void GraphWaveform::keyReleaseEvent(QKeyEvent *event) {
+  if ((event->key() == Qt::Key_Left || event->key() == Qt::Key_Right) &&
+      !event->isAutoRepeat()) {
+    finishPanning();
+  }
+
   if (event->key() == Qt::Key_Control) {
     m_isCtrlPressed = false;
     if (m_isToolTipShow) {
       m_isToolTipShow = false;
-      drawWaveform();
+      update();
     }
   }
 }
 
+void GraphWaveform::pan(int delta) {
+  p_signalData->setPanning(true);
+
+  if (!p_signalData->panArrayRange(delta)) return;
+
+  emit p_signalData->changedGraphTimeRange();
+}
+
+void GraphWaveform::finishPanning() {
+  if (!p_signalData->isPanning()) return;
+
+  p_signalData->setPanning(false);
+
+  // Масштаб по вертикали пересчитывается по новому диапазону.
+  emit p_signalData->changedGlobalScale();
+}
+
 void GraphWaveform::showToolTip(QMouseEvent *event) {
   if (!validateToolTipPoint(event)) return;
 
@@ -241,11 +315,9 @@ void GraphWaveform::showToolTip(QMouseEvent *event) {
   int arrayEnd = (p_signalData->samplesNumber() - 1) * timeEnd /
                  (p_signalData->allTime() - 1);
 
-  double max =
-      *std::max_element(p_data.begin() + arrayStart, p_data.begin() + arrayEnd);
-
-  double min =
-      *std::min_element(p_data.begin() + arrayStart, p_data.begin() + arrayEnd);
+  double min, max;
+  p_signalData->channelRange(p_number, arrayStart, arrayEnd - arrayStart, min,
+                             max);
 
   double avg = (max + min) / 2;
 
@@ -307,17 +379,11 @@ void GraphWaveform::initSelection(QMouseEvent *event) {
   m_selectionRect = QRect();
 }
 
-void GraphWaveform::onChangedEnableGrid() { drawWaveform(); }
+void GraphWaveform::onChangedEnableGrid() { scheduleWaveform(); }
 
-void GraphWaveform::onChangedGraphTimeRange() {
-  updateRelative();
-  drawWaveform();
-}
+void GraphWaveform::onChangedGraphTimeRange() { scheduleWaveform(); }
 
-void GraphWaveform::onChangedGlobalScale() {
-  updateRelative();
-  drawWaveform();
-}
+void GraphWaveform::onChangedGlobalScale() { scheduleWaveform(); }
 
 void GraphWaveform::drawName() {
   if (isImageNull()) throw BaseWaveform::ImageIsNull();
@@ -338,7 +404,7 @@ void GraphWaveform::drawName() {
   textRect.setHeight(p_maxTextHeight * 2);
 
   painter.drawText(textRect, Qt::AlignCenter | Qt::TextWordWrap,
-                   p_signalData->channelsName()[p_number]);
+                   p_name);
 }
 
 void GraphWaveform::drawAxisY() {
@@ -421,7 +487,7 @@ void GraphWaveform::drawAxisY() {
 void GraphWaveform::drawAxisTopX() {
   if (isImageNull()) throw BaseWaveform::ImageIsNull();
 
-  size_t timeRange = p_signalData->timeRange();
+  size_t timeRange = m_timeRange;
 
   QPainter painter(&p_image);
   painter.setPen(QPen(p_mainColor, p_axisLineWidth));
@@ -523,7 +589,7 @@ void GraphWaveform::drawAxisTopX() {
 void GraphWaveform::drawAxisBottomX() {
   if (isImageNull()) throw BaseWaveform::ImageIsNull();
 
-  size_t timeRange = p_signalData->timeRange();
+  size_t timeRange = m_timeRange;
 
   QPainter painter(&p_image);
   painter.setPen(QPen(p_mainColor, p_axisLineWidth));
@@ -626,9 +692,9 @@ void GraphWaveform::drawAxisBottomX() {
 void GraphWaveform::drawGrid() {
   if (isImageNull()) throw BaseWaveform::ImageIsNull();
 
-  if (!p_signalData->isGridEnabled()) return;
+  if (!m_isGridEnabled) return;
 
-  size_t timeRange = p_signalData->timeRange();
+  size_t timeRange = m_timeRange;
 
   QPainter painter(&p_image);
   painter.setPen(QPen(p_gridColor, p_gridLineWidth));
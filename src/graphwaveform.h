@@ -16,11 +16,9 @@ class GraphWaveform : public BaseWaveform {
  public:
   explicit GraphWaveform(std::shared_ptr<SignalData> signalData, int number,
                          QWidget *parent = nullptr);
+  ~GraphWaveform() override;
 
-  void drawWaveform() override;
-
-  void updateRelative();
-
+  // Положение среди графиков применяется со следующим кадром.
   void setTop();
   void setMiddle();
   void setBottom();
@@ -31,6 +29,9 @@ class GraphWaveform : public BaseWaveform {
   void onChangedGlobalScale();
 
  protected:
+  void prepareWaveform() override;
+  void renderWaveform() override;
+
   void mousePressEvent(QMouseEvent *event) override;
   void mouseMoveEvent(QMouseEvent *event) override;
   void mouseReleaseEvent(QMouseEvent *event) override;
@@ -43,6 +44,15 @@ class GraphWaveform : public BaseWaveform {
   void paintEvent(QPaintEvent *event) override;
 
  private:
+  enum Position { Top, Middle, Bottom };
+
+  void updateValueRange();
+  void updateRelative();
+
+  // Сдвиг вида стрелками или перетаскиванием средней кнопкой.
+  void pan(int delta);
+  void finishPanning();
+
   void showToolTip(QMouseEvent *event);
   bool validateToolTipPoint(QMouseEvent *event);
 
@@ -60,6 +70,11 @@ class GraphWaveform : public BaseWaveform {
   double m_dataPerPixel;
   double m_timePerPixel;
 
+  size_t m_timeRange;
+  bool m_isGridEnabled;
+
+  Position m_position = Middle;
+
   bool m_isTop;
   bool m_isBottom;
 
@@ -67,6 +82,10 @@ class GraphWaveform : public BaseWaveform {
   bool m_isCtrlPressed;
   bool m_isToolTipShow;
 
+  bool m_isDragging = false;
+  int m_dragStartX;
+  int m_dragStartArray;
+
   QPoint m_startPoint;
   QRect m_selectionRect;
   QPoint m_toolTipPoint;
@@ -0,0 +1,125 @@
+#include "histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace fssp {
+
+Histogram::Histogram(double min, double max, size_t binsNumber,
+                     Spacing spacing) {
+  if (!binsNumber || !(min <= max) || !std::isfinite(min) ||
+      !std::isfinite(max) || (spacing == Logarithmic && min <= 0)) {
+    throw Histogram::InvalidRange();
+  }
+
+  m_min = min;
+  m_max = max;
+  m_spacing = spacing;
+
+  if (m_spacing == Linear) {
+    m_offset = min;
+    m_scale = max > min ? binsNumber / (max - min) : 0;
+  } else {
+    m_offset = std::log(min);
+    m_scale = max > min ? binsNumber / (std::log(max) - m_offset) : 0;
+  }
+
+  m_counts = std::vector<size_t>(binsNumber, 0);
+}
+
+void Histogram::add(const double *data, size_t count) {
+  size_t bins = m_counts.size();
+  double last = static_cast<double>(bins - 1);
+
+  // Положение в единицах интервалов. Вне [0, bins) попадают значения за
+  // границами, NaN отсеивается сравнениями ниже.
+  double positions[blockSize];
+
+  // Несколько копий счетчиков, чтобы подряд идущие одинаковые номера не
+  // ждали друг друга при увеличении одного счетчика.
+  constexpr size_t copies = 4;
+  std::vector<size_t> counts(copies * bins, 0);
+
+  for (size_t done = 0; done < count; done += blockSize) {
+    const double *block = data + done;
+    size_t length = std::min(blockSize, count - done);
+
+    if (m_spacing == Linear) {
+      for (size_t i = 0; i < length; ++i) {
+        positions[i] = (block[i] - m_offset) * m_scale;
+      }
+    } else {
+      for (size_t i = 0; i < length; ++i) {
+        positions[i] = (std::log(block[i]) - m_offset) * m_scale;
+      }
+    }
+
+    for (size_t i = 0; i < length; ++i) {
+      double value = block[i];
+      if (value >= m_min && value <= m_max) {
+        size_t bin = static_cast<size_t>(std::min(positions[i], last));
+        ++counts[(i % copies) * bins + bin];
+      } else if (value > m_max) {
+        ++m_overflow;
+      } else {
+        ++m_underflow;
+      }
+    }
+  }
+
+  for (size_t copy = 0; copy < copies; ++copy) {
+    for (size_t bin = 0; bin < bins; ++bin) {
+      m_counts[bin] += counts[copy * bins + bin];
+    }
+  }
+}
+
+void Histogram::merge(const Histogram &that) {
+  for (size_t bin = 0; bin < m_counts.size(); ++bin) {
+    m_counts[bin] += that.m_counts[bin];
+  }
+
+  m_underflow += that.m_underflow;
+  m_overflow += that.m_overflow;
+}
+
+Histogram Histogram::empty() const {
+  Histogram histogram = *this;
+  std::fill(histogram.m_counts.begin(), histogram.m_counts.end(), 0);
+  histogram.m_underflow = 0;
+  histogram.m_overflow = 0;
+  return histogram;
+}
+
+size_t Histogram::binsNumber() const { return m_counts.size(); }
+
+Histogram::Spacing Histogram::spacing() const { return m_spacing; }
+
+double Histogram::min() const { return m_min; }
+
+double Histogram::max() const { return m_max; }
+
+double Histogram::binLeft(size_t i) const {
+  if (m_scale == 0) return m_min;
+
+  double position = m_offset + i / m_scale;
+  return m_spacing == Linear ? position : std::exp(position);
+}
+
+double Histogram::binRight(size_t i) const {
+  if (i + 1 == m_counts.size()) return m_max;
+
+  return binLeft(i + 1);
+}
+
+const std::vector<size_t> &Histogram::counts() const { return m_counts; }
+
+size_t Histogram::maxCount() const {
+  return *std::max_element(m_counts.begin(), m_counts.end());
+}
+
+size_t Histogram::underflow() const { return m_underflow; }
+
+size_t Histogram::overflow() const { return m_overflow; }
+
+}  // namespace fssp
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <vector>
+
+namespace fssp {
+
+// Гистограмма с линейными или логарифмическими интервалами. Номера
+// интервалов вычисляются блоками, гистограммы частей данных можно
+// вычислять независимо и объединять.
+class Histogram {
+ public:
+  enum Spacing { Linear, Logarithmic };
+
+  explicit Histogram(double min, double max, size_t binsNumber,
+                     Spacing spacing = Linear);
+
+  void add(const double *data, size_t count);
+
+  // Гистограммы должны иметь одинаковые интервалы.
+  void merge(const Histogram &that);
+
+  // Пустая гистограмма с теми же интервалами.
+  Histogram empty() const;
+
+  size_t binsNumber() const;
+  Spacing spacing() const;
+
+  double min() const;
+  double max() const;
+
+  // Границы интервала i.
+  double binLeft(size_t i) const;
+  double binRight(size_t i) const;
+
+  const std::vector<size_t> &counts() const;
+  size_t maxCount() const;
+
+  // Значения левее min (и неположительные при логарифмических
+  // интервалах), правее max и NaN.
+  size_t underflow() const;
+  size_t overflow() const;
+
+  class InvalidRange : public std::exception {
+   public:
+    virtual const char *what() const throw() {
+      return "Histogram range or bins number is invalid";
+    }
+  };
+
+ private:
+  static constexpr size_t blockSize = 1024;
+
+  double m_min;
+  double m_max;
+  Spacing m_spacing;
+
+  // Номер интервала: (f(x) - m_offset) * m_scale, где f - тождественная
+  // функция или логарифм.
+  double m_offset;
+  double m_scale;
+
+  std::vector<size_t> m_counts;
+  size_t m_underflow = 0;
+  size_t m_overflow = 0;
+};
+
+}  // namespace fssp
@@ -0,0 +1,85 @@
+#include "job.h"
+
+#include <algorithm>
+
+namespace fssp {
+
+thread_local Job *Job::t_current = nullptr;
+
+Job::Job(const QString &title) : m_title{title} {}
+
+const QString &Job::title() const { return m_title; }
+
+void Job::cancel() { m_cancelled = true; }
+
+bool Job::isCancelled() const { return m_cancelled; }
+
+const std::atomic<bool> &Job::cancelled() const { return m_cancelled; }
+
+void Job::check() const {
+  if (m_cancelled) throw Job::Cancelled();
+}
+
+void Job::setProgress(double progress) {
+  m_progress.store(std::clamp(progress, 0., 1.), std::memory_order_relaxed);
+}
+
+double Job::progress() const {
+  return m_progress.load(std::memory_order_relaxed);
+}
+
+Job *Job::current() { return t_current; }
+
+//
+
+JobManager &JobManager::instance() {
+  static JobManager manager;
+  return manager;
+}
+
+JobManager::JobManager(QObject *parent) : QObject{parent} {
+  m_timer = new QTimer(this);
+  m_timer->setInterval(refreshInterval);
+  connect(m_timer, &QTimer::timeout, this, &JobManager::progressChanged);
+}
+
+const std::vector<std::shared_ptr<Job>> &JobManager::jobs() const {
+  return m_jobs;
+}
+
+void JobManager::cancelAll() {
+  for (const std::shared_ptr<Job> &job : m_jobs) job->cancel();
+}
+
+std::shared_ptr<Job> JobManager::add(const QString &title, const QString &key) {
+  std::shared_ptr<Job> job = std::make_shared<Job>(title);
+
+  if (!key.isEmpty()) {
+    if (std::shared_ptr<Job> previous = m_keys[key].lock()) previous->cancel();
+    m_keys[key] = job;
+  }
+
+  m_jobs.push_back(job);
+  m_timer->start();
+
+  emit jobsChanged();
+
+  return job;
+}
+
+void JobManager::finish(const std::shared_ptr<Job> &job, const QString &error) {
+  m_jobs.erase(std::remove(m_jobs.begin(), m_jobs.end(), job), m_jobs.end());
+
+  for (auto it = m_keys.begin(); it != m_keys.end();) {
+    it = it->second.expired() || it->second.lock() == job ? m_keys.erase(it)
+                                                          : std::next(it);
+  }
+
+  if (m_jobs.empty()) m_timer->stop();
+
+  if (!error.isEmpty()) emit failed(job->title(), error);
+
+  emit jobsChanged();
+}
+
+}  // namespace fssp
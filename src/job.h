@@ -0,0 +1,144 @@
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QTimer>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "scheduler.h"
+
+namespace fssp {
+
+// Долгая операция: флаг отмены и доля выполненной работы. Ядра проверяют
+// отмену на границах блоков вызовом check().
+class Job {
+ public:
+  explicit Job(const QString &title);
+
+  const QString &title() const;
+
+  void cancel();
+  bool isCancelled() const;
+
+  // Для ядер, принимающих флаг отмены напрямую.
+  const std::atomic<bool> &cancelled() const;
+
+  // Бросает Cancelled, если операция отменена.
+  void check() const;
+
+  // Доля от 0 до 1. Вызывать можно сколь угодно часто: окно читает ее не
+  // чаще JobManager::refreshInterval.
+  void setProgress(double progress);
+  double progress() const;
+
+  // Операция, которая выполняется в текущем потоке, или nullptr. Нужна
+  // ядрам с фиксированным интерфейсом, например десериализаторам.
+  static Job *current();
+
+  class Cancelled : public std::exception {
+   public:
+    virtual const char *what() const throw() { return "Job is cancelled"; }
+  };
+
+ private:
+  friend class JobManager;
+
+  QString m_title;
+
+  std::atomic<bool> m_cancelled{false};
+  std::atomic<double> m_progress{0};
+
+  static thread_local Job *t_current;
+};
+
+// Запускает операции в общем пуле потоков и ведет список выполняющихся.
+// Методы вызываются из потока окна.
+class JobManager : public QObject {
+  Q_OBJECT
+ public:
+  static constexpr int refreshInterval = 100;
+
+  static JobManager &instance();
+
+  // Выполняет work в пуле потоков и передает результат done в потоке
+  // окна, если операция не отменена и context еще существует. Новая
+  // операция с тем же непустым key отменяет предыдущую, например расчет
+  // для устаревшего выделения.
+  template <typename Result>
+  std::shared_ptr<Job> run(const QString &title, const QString &key,
+                           QObject *context,
+                           std::function<Result(Job &job)> work,
+                           std::function<void(Result)> done);
+
+  const std::vector<std::shared_ptr<Job>> &jobs() const;
+
+  void cancelAll();
+
+ signals:
+  void jobsChanged();
+
+  // Не чаще раза в refreshInterval мс, пока есть операции.
+  void progressChanged();
+
+  void failed(const QString &title, const QString &message);
+
+ private:
+  explicit JobManager(QObject *parent = nullptr);
+
+  std::shared_ptr<Job> add(const QString &title, const QString &key);
+
+  // Вызывается в потоке окна после завершения операции.
+  void finish(const std::shared_ptr<Job> &job, const QString &error);
+
+  std::vector<std::shared_ptr<Job>> m_jobs;
+  std::map<QString, std::weak_ptr<Job>> m_keys;
+
+  QTimer *m_timer;
+};
+
+template <typename Result>
+std::shared_ptr<Job> JobManager::run(const QString &title, const QString &key,
+                                     QObject *context,
+                                     std::function<Result(Job &job)> work,
+                                     std::function<void(Result)> done) {
+  std::shared_ptr<Job> job = add(title, key);
+  QPointer<QObject> guard(context);
+
+  Scheduler::instance().submit(
+      [this, job, guard, work, done]() {
+        std::shared_ptr<Result> result;
+        QString error;
+
+        Job::t_current = job.get();
+        try {
+          job->check();
+          result = std::make_shared<Result>(work(*job));
+        } catch (Job::Cancelled) {
+        } catch (std::exception &exception) {
+          error = exception.what();
+        }
+        Job::t_current = nullptr;
+
+        // context проверяется в потоке окна, где его могут удалить.
+        QMetaObject::invokeMethod(
+            this,
+            [this, job, error, result, guard, done]() {
+              finish(job, error);
+              if (result && guard && !job->isCancelled()) {
+                done(std::move(*result));
+              }
+            },
+            Qt::QueuedConnection);
+      },
+      Scheduler::Interactive);
+
+  return job;
+}
+
+}  // namespace fssp
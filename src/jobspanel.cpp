@@ -0,0 +1,86 @@
+#include "jobspanel.h"
+
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+#include "job.h"
+
+namespace fssp {
+
+JobsPanel::JobsPanel(QWidget *parent) : QDockWidget{tr("Jobs"), parent} {
+  m_table = new QTableWidget(0, 2);
+  m_table->setHorizontalHeaderLabels({tr("Operation"), tr("Progress")});
+  m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+  m_table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+  m_table->verticalHeader()->hide();
+
+  QPushButton *cancelButton = new QPushButton(tr("Cancel"));
+  connect(cancelButton, &QPushButton::clicked, this,
+          &JobsPanel::onCancelButtonPress);
+
+  QPushButton *cancelAllButton = new QPushButton(tr("Cancel all"));
+  connect(cancelAllButton, &QPushButton::clicked, this,
+          []() { JobManager::instance().cancelAll(); });
+
+  QHBoxLayout *buttonLayout = new QHBoxLayout();
+  buttonLayout->addStretch();
+  buttonLayout->addWidget(cancelButton);
+  buttonLayout->addWidget(cancelAllButton);
+
+  QVBoxLayout *mainLayout = new QVBoxLayout();
+  mainLayout->addWidget(m_table);
+  mainLayout->addLayout(buttonLayout);
+
+  QWidget *content = new QWidget();
+  content->setLayout(mainLayout);
+  setWidget(content);
+
+  JobManager &manager = JobManager::instance();
+  connect(&manager, &JobManager::jobsChanged, this, &JobsPanel::onJobsChanged);
+  connect(&manager, &JobManager::progressChanged, this,
+          &JobsPanel::onProgressChanged);
+
+  onJobsChanged();
+}
+
+void JobsPanel::onJobsChanged() {
+  const std::vector<std::shared_ptr<Job>> &jobs =
+      JobManager::instance().jobs();
+
+  m_table->setRowCount(jobs.size());
+  for (int i = 0; i < jobs.size(); ++i) {
+    m_table->setItem(i, 0, new QTableWidgetItem(jobs[i]->title()));
+
+    QProgressBar *progressBar = new QProgressBar();
+    progressBar->setRange(0, 100);
+    m_table->setCellWidget(i, 1, progressBar);
+  }
+
+  onProgressChanged();
+}
+
+void JobsPanel::onProgressChanged() {
+  const std::vector<std::shared_ptr<Job>> &jobs =
+      JobManager::instance().jobs();
+
+  for (int i = 0; i < jobs.size() && i < m_table->rowCount(); ++i) {
+    QProgressBar *progressBar =
+        qobject_cast<QProgressBar *>(m_table->cellWidget(i, 1));
+    if (progressBar) progressBar->setValue(100 * jobs[i]->progress());
+  }
+}
+
+void JobsPanel::onCancelButtonPress() {
+  const std::vector<std::shared_ptr<Job>> &jobs =
+      JobManager::instance().jobs();
+
+  for (QModelIndex index : m_table->selectionModel()->selectedRows()) {
+    if (index.row() < jobs.size()) jobs[index.row()]->cancel();
+  }
+}
+
+}  // namespace fssp
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QDockWidget>
+#include <QTableWidget>
+#include <QWidget>
+
+namespace fssp {
+
+// Список выполняющихся операций с прогрессом и отменой выбранных.
+class JobsPanel : public QDockWidget {
+  Q_OBJECT
+ public:
+  explicit JobsPanel(QWidget *parent = nullptr);
+
+ protected slots:
+  void onJobsChanged();
+  void onProgressChanged();
+  void onCancelButtonPress();
+
+ private:
+  QTableWidget *m_table;
+};
+
+}  // namespace fssp
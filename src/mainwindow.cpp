@@ -1,13 +1,27 @@
 #include "mainwindow.h"
 
+#include <QStatusBar>
+#include <thread>
+
 #include "modelingwindow.h"
+#include "parallel.h"
+#include "pipelinewindow.h"
+#include "rankfilter.h"
+#include "resampler.h"
+#include "rollingstatistics.h"
 #include "spectrumwindow.h"
+#include "tilecache.h"
 
 namespace fssp {
 
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
+  m_jobsPanel = new JobsPanel(this);
+  m_jobsPanel->hide();
+  addDockWidget(Qt::BottomDockWidgetArea, m_jobsPanel);
+
   createActions();
   createMenus();
+  createStatusBar();
 
   m_lastDir = QDir::homePath();
   m_tabWidget = new QTabWidget();
@@ -48,9 +62,9 @@ void MainWindow::open() {
   m_lastDir = fileInfo.absolutePath();
   QString ext = fileInfo.suffix();
 
-  SignalPage *signalPage;
+  std::shared_ptr<BaseDeserializer> deserializer;
   try {
-    signalPage = SignalBuilder::FromFile(fileName, ext);
+    deserializer = SignalBuilder::DeserializerFor(ext);
   } catch (SignalBuilder::FileTypeError) {
     QMessageBox msgBox(this);
     msgBox.setText(tr("File type is not supported."));
@@ -60,9 +74,25 @@ void MainWindow::open() {
     if (ret == QMessageBox::Ok) {
       emit(MainWindow::open());
     }
+    return;
   }
 
-  m_tabWidget->addTab(signalPage, fileInfo.fileName());
+  // Файл читается в фоне, вкладка создается в потоке окна.
+  QString tabName = fileInfo.fileName();
+  QThread *windowThread = thread();
+
+  JobManager::instance().run<std::shared_ptr<SignalData>>(
+      tr("Opening ") + tabName, "", this,
+      [deserializer, fileName, windowThread](Job &) {
+        std::shared_ptr<SignalData> data =
+            std::make_shared<SignalData>((*deserializer)(fileName));
+        data->moveToThread(windowThread);
+
+        return data;
+      },
+      [this, tabName](std::shared_ptr<SignalData> data) {
+        m_tabWidget->addTab(new SignalPage(std::move(*data)), tabName);
+      });
 }
 
 void MainWindow::save() {
@@ -144,44 +174,96 @@ void MainWindow::save() {
     QString fileName = QFileDialog::getSaveFileName(
         this, tr("Save File"), m_lastDir, tr("Text files (*.txt)"));
 
-    QFile out(fileName + ".txt");
-    if (out.open(QIODevice::WriteOnly)) {
-      QTextStream stream(&out);
-      stream << "# channels number\n";
-      stream << signalData->channelsNumber() << "\n";
-      stream << "# samples number\n";
-      stream << toSpinBox->value() << "\n";
-      stream << "# sampling rate\n";
-      stream << signalData->rate() << "\n";
-      stream << "# start date\n";
-      stream << QLocale::system().toString(signalData->startTime().date(),
-                                           "dd.MM.yyyy")
-             << "\n";
-      stream << "# start time\n";
-      stream << QLocale::system().toString(signalData->startTime().time(),
-                                           "hh:mm:ss.zzz")
-             << "\n";
-      stream << "# channels names\n";
-      for (int i = 0; i < signalData->channelsNumber(); ++i) {
-        if (!checkBoxes[i]->isChecked()) continue;
-        stream << signalData->channelsName()[i] << ";";
-      }
-      stream << "\n";
+    if (fileName == "") {
+      dialog->reject();
+      return;
+    }
 
-      for (int i = fromSpinBox->value() - 1; i < toSpinBox->value(); ++i) {
-        for (int j = 0; j < signalData->channelsNumber(); ++j) {
-          if (!checkBoxes[j]->isChecked()) continue;
-          stream << signalData->data()[j][i] << " ";
-        }
-        stream << "\n";
-      }
-      out.close();
+    // Каналы и имена запоминаются здесь: пока идет сохранение, окно может
+    // добавить в сигнал новый канал.
+    std::vector<std::shared_ptr<const ChannelSource>> channels;
+    std::vector<QString> channelsName;
+    for (int i = 0; i < checkBoxes.size(); ++i) {
+      if (!checkBoxes[i]->isChecked()) continue;
+      channels.push_back(signalData->channel(i));
+      channelsName.push_back(signalData->channelsName()[i]);
     }
 
+    int from = fromSpinBox->value();
+    int to = toSpinBox->value();
+
+    JobManager::instance().run<bool>(
+        tr("Saving ") + QFileInfo(fileName).fileName(), "", this,
+        [signalData, channels, channelsName, from, to, fileName](Job &job) {
+          saveSignal(*signalData, channels, channelsName, from, to,
+                     fileName + ".txt", job);
+          return true;
+        },
+        [this, fileName](bool) {
+          statusBar()->showMessage(tr("Saved ") + fileName + ".txt", 5000);
+        });
+
     dialog->reject();
   }
 }
 
+void MainWindow::saveSignal(
+    const SignalData &signalData,
+    const std::vector<std::shared_ptr<const ChannelSource>> &channels,
+    const std::vector<QString> &channelsName, int from, int to,
+    const QString &fileName, Job &job) {
+  QFile out(fileName);
+  if (!out.open(QIODevice::WriteOnly)) return;
+
+  QTextStream stream(&out);
+  stream << "# channels number\n";
+  stream << static_cast<int>(channels.size()) << "\n";
+  stream << "# samples number\n";
+  stream << to << "\n";
+  stream << "# sampling rate\n";
+  stream << signalData.rate() << "\n";
+  stream << "# start date\n";
+  stream << QLocale::system().toString(signalData.startTime().date(),
+                                       "dd.MM.yyyy")
+         << "\n";
+  stream << "# start time\n";
+  stream << QLocale::system().toString(signalData.startTime().time(),
+                                       "hh:mm:ss.zzz")
+         << "\n";
+  stream << "# channels names\n";
+  for (const QString &name : channelsName) stream << name << ";";
+  stream << "\n";
+
+  // Каналы читаются блоками, чтобы не держать в памяти каналы моделей.
+  constexpr int blockSize = 1 << 16;
+
+  std::vector<std::vector<double>> block(channels.size());
+  for (int start = from - 1; start < to; start += blockSize) {
+    // Отмененное сохранение не оставляет недописанный файл.
+    if (job.isCancelled()) {
+      out.close();
+      out.remove();
+      job.check();
+    }
+    job.setProgress(static_cast<double>(start - from + 1) / (to - from + 1));
+
+    int count = std::min(blockSize, to - start);
+
+    for (size_t j = 0; j < channels.size(); ++j) {
+      block[j].resize(count);
+      channels[j]->read(start, count, block[j].data());
+    }
+
+    for (int i = 0; i < count; ++i) {
+      for (size_t j = 0; j < channels.size(); ++j) {
+        stream << block[j][i] << " ";
+      }
+      stream << "\n";
+    }
+  }
+  out.close();
+}
+
 void MainWindow::aboutSignal() {
   if (!m_tabWidget->count()) {
     QMessageBox::information(this, tr("About signal"),
@@ -245,9 +327,12 @@ void MainWindow::modInCurSignal() {
   int ret = modWindow->exec();
   if (!ret) return;
 
+  // При переборе параметров модель возвращает несколько каналов.
   SignalData modelingData = modWindow->getData();
-
-  signalData->addData(modelingData.channelsName()[0], modelingData.data()[0]);
+  for (int i = 0; i < modelingData.channelsNumber(); ++i) {
+    signalData->addChannel(modelingData.channelsName()[i],
+                           modelingData.channel(i));
+  }
   signalData->setDefault();
   signalData->setSpectrumDefault();
   emit signalData->dataAdded();
@@ -268,12 +353,592 @@ void MainWindow::spectrumAnalize() {
   spectrum->show();
 }
 
+void MainWindow::resample() {
+  if (!m_tabWidget->count()) {
+    QMessageBox::information(
+        this, tr("Error"), tr("There is no open signal yet"), QMessageBox::Ok);
+    return;
+  }
+
+  SignalPage *signalPage =
+      dynamic_cast<SignalPage *>(m_tabWidget->currentWidget());
+  std::shared_ptr<SignalData> signalData = signalPage->getSignalData();
+
+  QDialog *dialog = new QDialog();
+  dialog->setWindowTitle(tr("Resampling"));
+
+  QSpinBox *upSpinBox = new QSpinBox();
+  upSpinBox->setRange(1, 1000);
+  upSpinBox->setValue(1);
+
+  QSpinBox *downSpinBox = new QSpinBox();
+  downSpinBox->setRange(1, 1000);
+  downSpinBox->setValue(2);
+
+  QLabel *rateLabel = new QLabel();
+
+  auto updateRate = [=]() {
+    rateLabel->setText(tr("New sampling frequency: ") +
+                       QString::number(signalData->rate() * upSpinBox->value() /
+                                       downSpinBox->value()) +
+                       tr(" HZ"));
+  };
+  updateRate();
+
+  connect(upSpinBox, &QSpinBox::valueChanged, dialog, updateRate);
+  connect(downSpinBox, &QSpinBox::valueChanged, dialog, updateRate);
+
+  QFormLayout *formLayout = new QFormLayout();
+  formLayout->addRow(tr("Interpolation factor (L):"), upSpinBox);
+  formLayout->addRow(tr("Decimation factor (M):"), downSpinBox);
+  formLayout->addRow(rateLabel);
+
+  QDialogButtonBox *buttonBox =
+      new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+
+  connect(buttonBox, &QDialogButtonBox::accepted, dialog, &QDialog::accept);
+  connect(buttonBox, &QDialogButtonBox::rejected, dialog, &QDialog::reject);
+
+  QVBoxLayout *dialogLayout = new QVBoxLayout();
+  dialogLayout->addLayout(formLayout);
+  dialogLayout->addWidget(buttonBox);
+
+  dialog->setLayout(dialogLayout);
+  dialog->setFixedSize(dialog->sizeHint());
+
+  dialog->exec();
+
+  if (dialog->result() == QDialog::Accepted) {
+    SignalPage *resampledPage = new SignalPage(
+        signalData->resampled(upSpinBox->value(), downSpinBox->value()));
+
+    QString rate = QString::number(resampledPage->getSignalData()->rate());
+
+    m_tabWidget->addTab(resampledPage,
+                        m_tabWidget->tabText(m_tabWidget->currentIndex()) +
+                            " (" + rate + tr(" HZ") + ")");
+  }
+
+  dialog->deleteLater();
+}
+
+void MainWindow::rankFilter() {
+  if (!m_tabWidget->count()) {
+    QMessageBox::information(
+        this, tr("Error"), tr("There is no open signal yet"), QMessageBox::Ok);
+    return;
+  }
+
+  SignalPage *signalPage =
+      dynamic_cast<SignalPage *>(m_tabWidget->currentWidget());
+  std::shared_ptr<SignalData> signalData = signalPage->getSignalData();
+
+  QDialog *dialog = new QDialog();
+  dialog->setWindowTitle(tr("Rank filter"));
+
+  QComboBox *typeComboBox = new QComboBox();
+  typeComboBox->addItem(tr("Median"));
+  typeComboBox->addItem(tr("Percentile"));
+  typeComboBox->addItem(tr("Minimum"));
+  typeComboBox->addItem(tr("Maximum"));
+
+  // Окно шире канала дает ту же медиану, но стоит O(w) памяти.
+  QSpinBox *windowSpinBox = new QSpinBox();
+  windowSpinBox->setRange(1, std::max(1, signalData->samplesNumber()));
+  windowSpinBox->setValue(std::min(5, windowSpinBox->maximum()));
+
+  QDoubleSpinBox *percentileSpinBox = new QDoubleSpinBox();
+  percentileSpinBox->setRange(0, 100);
+  percentileSpinBox->setValue(50);
+  percentileSpinBox->setEnabled(false);
+
+  connect(typeComboBox, &QComboBox::currentIndexChanged, dialog,
+          [=](int index) { percentileSpinBox->setEnabled(index == 1); });
+
+  QFormLayout *formLayout = new QFormLayout();
+  formLayout->addRow(tr("Filter:"), typeComboBox);
+  formLayout->addRow(tr("Window width:"), windowSpinBox);
+  formLayout->addRow(tr("Percentile:"), percentileSpinBox);
+
+  std::vector<QCheckBox *> checkBoxes;
+
+  QHBoxLayout *checkBoxesLayout = new QHBoxLayout();
+
+  for (int i = 0; i < signalData->channelsNumber(); ++i) {
+    QCheckBox *checkBox = new QCheckBox(signalData->channelsName()[i]);
+    checkBoxes.push_back(checkBox);
+
+    checkBoxesLayout->addWidget(checkBox);
+  }
+
+  QDialogButtonBox *buttonBox =
+      new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+
+  connect(buttonBox, &QDialogButtonBox::accepted, dialog, &QDialog::accept);
+  connect(buttonBox, &QDialogButtonBox::rejected, dialog, &QDialog::reject);
+
+  QLabel *noteCheckBoxes = new QLabel(tr("Choose the channel"));
+
+  QVBoxLayout *dialogLayout = new QVBoxLayout();
+  dialogLayout->addLayout(formLayout);
+  dialogLayout->addWidget(noteCheckBoxes);
+  dialogLayout->addLayout(checkBoxesLayout);
+  dialogLayout->addWidget(buttonBox);
+
+  dialog->setLayout(dialogLayout);
+  dialog->setFixedSize(dialog->sizeHint());
+
+  dialog->exec();
+
+  if (dialog->result() == QDialog::Accepted) {
+    std::vector<int> channels;
+    for (int i = 0; i < checkBoxes.size(); ++i) {
+      if (checkBoxes[i]->isChecked()) channels.push_back(i);
+    }
+
+    RankFilter::Type type =
+        static_cast<RankFilter::Type>(typeComboBox->currentIndex());
+    int windowSize = windowSpinBox->value();
+    double percentile = percentileSpinBox->value();
+
+    std::vector<std::vector<double>> filtered(channels.size());
+    parallelFor(0, channels.size(), [&](size_t i) {
+      filtered[i] = RankFilter::filter(signalData->channelData(channels[i]),
+                                       type, windowSize, percentile);
+    });
+
+    QString suffix = "_" + typeComboBox->currentText().toLower() + "_" +
+                     QString::number(windowSize);
+
+    for (int i = 0; i < channels.size(); ++i) {
+      signalData->addData(signalData->channelsName()[channels[i]] + suffix,
+                          std::move(filtered[i]));
+    }
+
+    if (!channels.empty()) {
+      signalData->setDefault();
+      signalData->setSpectrumDefault();
+      emit signalData->dataAdded();
+    }
+  }
+
+  dialog->deleteLater();
+}
+
+void MainWindow::rollingStatistics() {
+  if (!m_tabWidget->count()) {
+    QMessageBox::information(
+        this, tr("Error"), tr("There is no open signal yet"), QMessageBox::Ok);
+    return;
+  }
+
+  SignalPage *signalPage =
+      dynamic_cast<SignalPage *>(m_tabWidget->currentWidget());
+  std::shared_ptr<SignalData> signalData = signalPage->getSignalData();
+
+  QDialog *dialog = new QDialog();
+  dialog->setWindowTitle(tr("Rolling statistics"));
+
+  QSpinBox *windowSpinBox = new QSpinBox();
+  windowSpinBox->setRange(1, INT_MAX);
+  windowSpinBox->setValue(100);
+
+  QSpinBox *hopSpinBox = new QSpinBox();
+  hopSpinBox->setRange(1, INT_MAX);
+  hopSpinBox->setValue(1);
+
+  QFormLayout *formLayout = new QFormLayout();
+  formLayout->addRow(tr("Window width:"), windowSpinBox);
+  formLayout->addRow(tr("Hop:"), hopSpinBox);
+
+  QStringList typesName = {tr("Mean"),    tr("RMS"),     tr("Std"),
+                           tr("Minimum"), tr("Maximum"), tr("Peak-to-peak")};
+
+  std::vector<QCheckBox *> typeCheckBoxes;
+
+  QHBoxLayout *typeCheckBoxesLayout = new QHBoxLayout();
+
+  for (const QString &typeName : typesName) {
+    QCheckBox *checkBox = new QCheckBox(typeName);
+    typeCheckBoxes.push_back(checkBox);
+
+    typeCheckBoxesLayout->addWidget(checkBox);
+  }
+
+  typeCheckBoxes[0]->setChecked(true);
+
+  std::vector<QCheckBox *> checkBoxes;
+
+  QHBoxLayout *checkBoxesLayout = new QHBoxLayout();
+
+  for (int i = 0; i < signalData->channelsNumber(); ++i) {
+    QCheckBox *checkBox = new QCheckBox(signalData->channelsName()[i]);
+    checkBoxes.push_back(checkBox);
+
+    checkBoxesLayout->addWidget(checkBox);
+  }
+
+  QDialogButtonBox *buttonBox =
+      new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+
+  connect(buttonBox, &QDialogButtonBox::accepted, dialog, &QDialog::accept);
+  connect(buttonBox, &QDialogButtonBox::rejected, dialog, &QDialog::reject);
+
+  QLabel *noteTypeCheckBoxes = new QLabel(tr("Choose the statistics"));
+  QLabel *noteCheckBoxes = new QLabel(tr("Choose the channel"));
+
+  QVBoxLayout *dialogLayout = new QVBoxLayout();
+  dialogLayout->addLayout(formLayout);
+  dialogLayout->addWidget(noteTypeCheckBoxes);
+  dialogLayout->addLayout(typeCheckBoxesLayout);
+  dialogLayout->addWidget(noteCheckBoxes);
+  dialogLayout->addLayout(checkBoxesLayout);
+  dialogLayout->addWidget(buttonBox);
+
+  dialog->setLayout(dialogLayout);
+  dialog->setFixedSize(dialog->sizeHint());
+
+  dialog->exec();
+
+  if (dialog->result() == QDialog::Accepted) {
+    std::vector<int> channels;
+    for (int i = 0; i < checkBoxes.size(); ++i) {
+      if (checkBoxes[i]->isChecked()) channels.push_back(i);
+    }
+
+    std::vector<RollingStatistics::Type> types;
+    std::vector<QString> typesSuffix;
+    for (int i = 0; i < typeCheckBoxes.size(); ++i) {
+      if (!typeCheckBoxes[i]->isChecked()) continue;
+
+      types.push_back(static_cast<RollingStatistics::Type>(i));
+      typesSuffix.push_back("_" + typesName[i].toLower());
+    }
+
+    int windowSize = windowSpinBox->value();
+    int hop = hopSpinBox->value();
+
+    RollingStatistics statistics(windowSize, hop);
+
+    // Все статистики канала считаются за один проход, каналы параллельно
+    std::vector<std::vector<std::vector<double>>> computed(channels.size());
+    parallelFor(0, channels.size(), [&](size_t i) {
+      computed[i] =
+          statistics.compute(signalData->channelData(channels[i]), types);
+    });
+
+    std::vector<QString> channelsName;
+    std::vector<std::vector<double>> data;
+    for (int i = 0; i < channels.size(); ++i) {
+      for (int j = 0; j < types.size(); ++j) {
+        channelsName.push_back(signalData->channelsName()[channels[i]] +
+                               typesSuffix[j] + "_" +
+                               QString::number(windowSize));
+        data.push_back(std::move(computed[i][j]));
+      }
+    }
+
+    if (hop == 1) {
+      for (int i = 0; i < data.size(); ++i) {
+        signalData->addData(channelsName[i], std::move(data[i]));
+      }
+
+      if (!data.empty()) {
+        signalData->setDefault();
+        signalData->setSpectrumDefault();
+        emit signalData->dataAdded();
+      }
+    } else if (!data.empty()) {
+      // Прореженные каналы короче исходных, поэтому открываются отдельным
+      // сигналом с частотой дискретизации в hop раз меньше
+      double rate = signalData->rate() / hop;
+      double timeForOne = 1. / rate;
+      size_t allTime = (timeForOne * data[0].size()) * 1000;
+
+      SignalPage *statisticsPage = new SignalPage(SignalData(
+          signalData->startTime(), signalData->startTime().addMSecs(allTime),
+          rate, timeForOne, allTime, std::move(channelsName),
+          std::move(data)));
+
+      m_tabWidget->addTab(statisticsPage,
+                          m_tabWidget->tabText(m_tabWidget->currentIndex()) +
+                              " (" + QString::number(rate) + tr(" HZ") +
+                              ")");
+    }
+  }
+
+  dialog->deleteLater();
+}
+
+void MainWindow::applyPipeline() {
+  if (!m_tabWidget->count()) {
+    QMessageBox::information(
+        this, tr("Error"), tr("There is no open signal yet"), QMessageBox::Ok);
+    return;
+  }
+
+  SignalPage *signalPage =
+      dynamic_cast<SignalPage *>(m_tabWidget->currentWidget());
+  std::shared_ptr<SignalData> signalData = signalPage->getSignalData();
+
+  PipelineWindow *pipelineWindow =
+      new PipelineWindow(signalData, m_pipeline, this);
+
+  int ret = pipelineWindow->exec();
+  pipelineWindow->deleteLater();
+  if (!ret) return;
+
+  m_pipeline = pipelineWindow->pipeline();
+
+  std::vector<int> channels = pipelineWindow->channels();
+  if (channels.empty() || m_pipeline.isEmpty()) return;
+
+  std::vector<std::vector<double>> processed(channels.size());
+  try {
+    // Каналы читаются блоками, чтобы процедурные не разворачивались целиком.
+    parallelFor(0, channels.size(), [&](size_t i) {
+      std::shared_ptr<const ChannelSource> source =
+          signalData->channel(channels[i]);
+      Pipeline::Stream stream(m_pipeline, signalData->rate());
+
+      std::vector<double> block(Pipeline::blockSize);
+      for (size_t start = 0; start < source->size();
+           start += Pipeline::blockSize) {
+        size_t count = std::min(Pipeline::blockSize, source->size() - start);
+        source->read(start, count, block.data());
+        stream.process(block.data(), count, processed[i]);
+      }
+      stream.flush(processed[i]);
+    });
+  } catch (const std::exception &error) {
+    QMessageBox::information(this, tr("Error"),
+                             tr("Pipeline failed: ") + error.what(),
+                             QMessageBox::Ok);
+    return;
+  }
+
+  std::vector<QString> channelsName;
+  for (int channel : channels) {
+    channelsName.push_back(signalData->channelsName()[channel] + "_pipeline");
+  }
+
+  double rate = m_pipeline.outputRate(signalData->rate());
+
+  if (rate == signalData->rate() &&
+      static_cast<int>(processed[0].size()) == signalData->samplesNumber()) {
+    for (size_t i = 0; i < channels.size(); ++i) {
+      signalData->addData(channelsName[i], std::move(processed[i]));
+    }
+
+    signalData->setDefault();
+    signalData->setSpectrumDefault();
+    emit signalData->dataAdded();
+
+    return;
+  }
+
+  // Частота изменилась - результат открывается в новой вкладке.
+  double timeForOne = 1. / rate;
+  size_t allTime = (timeForOne * processed[0].size()) * 1000;
+
+  SignalPage *processedPage = new SignalPage(
+      SignalData(signalData->startTime(),
+                 signalData->startTime().addMSecs(allTime), rate, timeForOne,
+                 allTime, std::move(channelsName), std::move(processed)));
+
+  m_tabWidget->addTab(processedPage,
+                      m_tabWidget->tabText(m_tabWidget->currentIndex()) +
+                          tr(" (pipeline)"));
+}
+
+void MainWindow::importChannel() {
+  if (m_tabWidget->count() < 2) {
+    QMessageBox::information(this, tr("Error"),
+                             tr("There is no other open signal to import from"),
+                             QMessageBox::Ok);
+    return;
+  }
+
+  SignalPage *signalPage =
+      dynamic_cast<SignalPage *>(m_tabWidget->currentWidget());
+  std::shared_ptr<SignalData> signalData = signalPage->getSignalData();
+
+  QDialog *dialog = new QDialog();
+  dialog->setWindowTitle(tr("Import channel"));
+
+  std::vector<std::pair<std::shared_ptr<SignalData>, int>> channels;
+
+  QComboBox *comboBox = new QComboBox();
+  for (int i = 0; i < m_tabWidget->count(); ++i) {
+    if (i == m_tabWidget->currentIndex()) continue;
+
+    SignalPage *page = dynamic_cast<SignalPage *>(m_tabWidget->widget(i));
+    std::shared_ptr<SignalData> data = page->getSignalData();
+
+    for (int j = 0; j < data->channelsNumber(); ++j) {
+      comboBox->addItem(m_tabWidget->tabText(i) + ": " +
+                        data->channelsName()[j]);
+      channels.push_back({data, j});
+    }
+  }
+
+  QDialogButtonBox *buttonBox =
+      new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+
+  connect(buttonBox, &QDialogButtonBox::accepted, dialog, &QDialog::accept);
+  connect(buttonBox, &QDialogButtonBox::rejected, dialog, &QDialog::reject);
+
+  QLabel *noteComboBox = new QLabel(
+      tr("Choose the channel (it will be resampled to the current rate)"));
+
+  QVBoxLayout *dialogLayout = new QVBoxLayout();
+  dialogLayout->addWidget(noteComboBox);
+  dialogLayout->addWidget(comboBox);
+  dialogLayout->addWidget(buttonBox);
+
+  dialog->setLayout(dialogLayout);
+  dialog->setFixedSize(dialog->sizeHint());
+
+  dialog->exec();
+
+  if (dialog->result() == QDialog::Accepted && comboBox->currentIndex() >= 0) {
+    auto [source, channel] = channels[comboBox->currentIndex()];
+
+    try {
+      signalData->addData(source->channelsName()[channel],
+                          signalData->conformChannel(*source, channel));
+      signalData->setDefault();
+      signalData->setSpectrumDefault();
+      emit signalData->dataAdded();
+    } catch (Resampler::UnsupportedRatio) {
+      QMessageBox::information(
+          this, tr("Error"),
+          tr("The sampling rates differ too much to resample the channel"),
+          QMessageBox::Ok);
+    }
+  }
+
+  dialog->deleteLater();
+}
+
 void MainWindow::handleCloseTabEvent(int index) {
   QWidget *signalPage = m_tabWidget->widget(index);
   m_tabWidget->removeTab(index);
   delete signalPage;
 }
 
+void MainWindow::deriveChannel() {
+  if (!m_tabWidget->count()) {
+    QMessageBox::information(
+        this, tr("Error"), tr("There is no open signal yet"), QMessageBox::Ok);
+    return;
+  }
+
+  SignalPage *signalPage =
+      dynamic_cast<SignalPage *>(m_tabWidget->currentWidget());
+  std::shared_ptr<SignalData> signalData = signalPage->getSignalData();
+
+  QDialog *dialog = new QDialog();
+  dialog->setWindowTitle(tr("Derived channel"));
+
+  // Порядок совпадает с DerivedChannel::Operation.
+  QComboBox *operationComboBox = new QComboBox();
+  operationComboBox->addItem(tr("Sum"));
+  operationComboBox->addItem(tr("Difference"));
+  operationComboBox->addItem(tr("Product"));
+  operationComboBox->addItem(tr("Scale"));
+  operationComboBox->addItem(tr("Rectify"));
+  operationComboBox->addItem(tr("Derivative"));
+
+  QComboBox *firstComboBox = new QComboBox();
+  QComboBox *secondComboBox = new QComboBox();
+  for (int i = 0; i < signalData->channelsNumber(); ++i) {
+    firstComboBox->addItem(signalData->channelsName()[i]);
+    secondComboBox->addItem(signalData->channelsName()[i]);
+  }
+
+  QDoubleSpinBox *factorSpinBox = new QDoubleSpinBox();
+  factorSpinBox->setDecimals(6);
+  factorSpinBox->setRange(-1e9, 1e9);
+  factorSpinBox->setValue(1);
+  factorSpinBox->setEnabled(false);
+
+  connect(operationComboBox, &QComboBox::currentIndexChanged, dialog,
+          [=](int index) {
+            secondComboBox->setEnabled(index <= DerivedChannel::Product);
+            factorSpinBox->setEnabled(index == DerivedChannel::Scale);
+          });
+
+  QFormLayout *formLayout = new QFormLayout();
+  formLayout->addRow(tr("Operation:"), operationComboBox);
+  formLayout->addRow(tr("First channel:"), firstComboBox);
+  formLayout->addRow(tr("Second channel:"), secondComboBox);
+  formLayout->addRow(tr("Factor:"), factorSpinBox);
+
+  QDialogButtonBox *buttonBox =
+      new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+
+  connect(buttonBox, &QDialogButtonBox::accepted, dialog, &QDialog::accept);
+  connect(buttonBox, &QDialogButtonBox::rejected, dialog, &QDialog::reject);
+
+  QVBoxLayout *dialogLayout = new QVBoxLayout();
+  dialogLayout->addLayout(formLayout);
+  dialogLayout->addWidget(buttonBox);
+
+  dialog->setLayout(dialogLayout);
+  dialog->setFixedSize(dialog->sizeHint());
+
+  dialog->exec();
+
+  if (dialog->result() == QDialog::Accepted) {
+    DerivedChannel::Operation operation =
+        static_cast<DerivedChannel::Operation>(
+            operationComboBox->currentIndex());
+
+    int first = firstComboBox->currentIndex();
+    int second = secondComboBox->currentIndex();
+    double factor = factorSpinBox->value();
+
+    QString a = signalData->channelsName()[first];
+    QString b = signalData->channelsName()[second];
+
+    QString name;
+    switch (operation) {
+      case DerivedChannel::Sum:
+        name = a + "+" + b;
+        break;
+      case DerivedChannel::Difference:
+        name = a + "-" + b;
+        break;
+      case DerivedChannel::Product:
+        name = a + "*" + b;
+        break;
+      case DerivedChannel::Scale:
+        name = QString::number(factor) + "*" + a;
+        break;
+      case DerivedChannel::Rectify:
+        name = "|" + a + "|";
+        break;
+      case DerivedChannel::Derivative:
+        name = "d(" + a + ")/dt";
+        break;
+    }
+
+    // Канал хранит только ссылки на исходные каналы, отсчеты вычисляются
+    // при чтении.
+    signalData->addChannel(
+        name, std::make_shared<DerivedChannel>(
+                  operation, signalData->channel(first),
+                  signalData->channel(second), factor, signalData->rate()));
+
+    signalData->setDefault();
+    signalData->setSpectrumDefault();
+    emit signalData->dataAdded();
+  }
+
+  dialog->deleteLater();
+}
+
 void MainWindow::createActions() {
   m_aboutFsspAct = new QAction(tr("About"), this);
   connect(m_aboutFsspAct, &QAction::triggered, this, &MainWindow::aboutFssp);
@@ -300,28 +965,78 @@ void MainWindow::createActions() {
   connect(m_statisticAct, &QAction::triggered, this,
           &MainWindow::chooseStatisticSignal);
 
+  m_statisticTableAct = new QAction(tr("Statistic table"), this);
+  connect(m_statisticTableAct, &QAction::triggered, this,
+          &MainWindow::showStatisticTable);
+
+  m_rollingStatisticsAct = new QAction(tr("Rolling statistics..."), this);
+  connect(m_rollingStatisticsAct, &QAction::triggered, this,
+          &MainWindow::rollingStatistics);
+
   m_spectrumAnalizeAct = new QAction(tr("Spectrum analize"), this);
   connect(m_spectrumAnalizeAct, &QAction::triggered, this,
           &MainWindow::spectrumAnalize);
+
+  m_resampleAct = new QAction(tr("Resample..."), this);
+  connect(m_resampleAct, &QAction::triggered, this, &MainWindow::resample);
+
+  m_rankFilterAct = new QAction(tr("Rank filter..."), this);
+  connect(m_rankFilterAct, &QAction::triggered, this, &MainWindow::rankFilter);
+
+  m_pipelineAct = new QAction(tr("Pipeline..."), this);
+  connect(m_pipelineAct, &QAction::triggered, this,
+          &MainWindow::applyPipeline);
+
+  m_importChannelAct = new QAction(tr("Import channel..."), this);
+  connect(m_importChannelAct, &QAction::triggered, this,
+          &MainWindow::importChannel);
+
+  m_deriveChannelAct = new QAction(tr("Derived channel..."), this);
+  connect(m_deriveChannelAct, &QAction::triggered, this,
+          &MainWindow::deriveChannel);
+
+  m_threadsNumberAct = new QAction(tr("Threads..."), this);
+  connect(m_threadsNumberAct, &QAction::triggered, this,
+          &MainWindow::chooseThreadsNumber);
+
+  m_tileCacheAct = new QAction(tr("Tile cache..."), this);
+  connect(m_tileCacheAct, &QAction::triggered, this,
+          &MainWindow::chooseTileCacheBudget);
+
+  m_quantileAccuracyAct = new QAction(tr("Quantile accuracy..."), this);
+  connect(m_quantileAccuracyAct, &QAction::triggered, this,
+          &MainWindow::chooseQuantileAccuracy);
 }
 
 void MainWindow::createMenus() {
   m_fileMenu = menuBar()->addMenu(tr("&File"));
   m_fileMenu->addAction(m_openAct);
   m_fileMenu->addAction(m_saveAct);
+  m_fileMenu->addAction(m_importChannelAct);
   m_fileMenu->addAction(m_aboutSignalAct);
 
   m_modelingMenu = menuBar()->addMenu(tr("&Modeling"));
   m_modelingMenu->addAction(m_modNewSignalAct);
   m_modelingMenu->addAction(m_modInCurSignalAct);
+  m_modelingMenu->addAction(m_deriveChannelAct);
 
   m_analizeMenu = menuBar()->addMenu(tr("&Analysis"));
   m_analizeMenu->addAction(m_statisticAct);
+  m_analizeMenu->addAction(m_statisticTableAct);
+  m_analizeMenu->addAction(m_rollingStatisticsAct);
   m_analizeMenu->addAction(m_spectrumAnalizeAct);
 
   m_filterMenu = menuBar()->addMenu(tr("&Filter"));
+  m_filterMenu->addAction(m_rankFilterAct);
+  m_filterMenu->addAction(m_resampleAct);
+  m_filterMenu->addSeparator();
+  m_filterMenu->addAction(m_pipelineAct);
 
   m_settingsMenu = menuBar()->addMenu(tr("&Settings"));
+  m_settingsMenu->addAction(m_threadsNumberAct);
+  m_settingsMenu->addAction(m_tileCacheAct);
+  m_settingsMenu->addAction(m_quantileAccuracyAct);
+  m_settingsMenu->addAction(m_jobsPanel->toggleViewAction());
 
   m_helpMenu = menuBar()->addMenu(tr("Help"));
   m_helpMenu->addAction(m_aboutFsspAct);
@@ -387,4 +1102,214 @@ void MainWindow::chooseStatisticSignal() {
   }
 }
 
+void MainWindow::showStatisticTable() {
+  if (!m_tabWidget->count()) {
+    QMessageBox::information(
+        this, tr("Error"), tr("There is no open signal yet"), QMessageBox::Ok);
+    return;
+  }
+
+  SignalPage *signalPage =
+      dynamic_cast<SignalPage *>(m_tabWidget->currentWidget());
+
+  StatisticTableWindow *table =
+      new StatisticTableWindow(signalPage->getSignalData(), this);
+  table->setAttribute(Qt::WA_DeleteOnClose);
+
+  table->show();
+}
+
+void MainWindow::chooseThreadsNumber() {
+  Scheduler &scheduler = Scheduler::instance();
+
+  QDialog *dialog = new QDialog();
+  dialog->setWindowTitle(tr("Threads"));
+
+  QSpinBox *threadsSpinBox = new QSpinBox();
+  threadsSpinBox->setRange(1, Scheduler::maxThreadsNumber);
+  threadsSpinBox->setValue(scheduler.threadsNumber());
+
+  QLabel *noteLabel =
+      new QLabel(tr("Processor cores: ") +
+                 QString::number(std::thread::hardware_concurrency()));
+
+  QFormLayout *formLayout = new QFormLayout();
+  formLayout->addRow(tr("Computing threads:"), threadsSpinBox);
+  formLayout->addRow(noteLabel);
+
+  QDialogButtonBox *buttonBox =
+      new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+
+  connect(buttonBox, &QDialogButtonBox::accepted, dialog, &QDialog::accept);
+  connect(buttonBox, &QDialogButtonBox::rejected, dialog, &QDialog::reject);
+
+  QVBoxLayout *dialogLayout = new QVBoxLayout();
+  dialogLayout->addLayout(formLayout);
+  dialogLayout->addWidget(buttonBox);
+
+  dialog->setLayout(dialogLayout);
+  dialog->setFixedSize(dialog->sizeHint());
+
+  dialog->exec();
+
+  if (dialog->result() == QDialog::Accepted) {
+    scheduler.setThreadsNumber(threadsSpinBox->value());
+  }
+
+  dialog->deleteLater();
+}
+
+void MainWindow::chooseTileCacheBudget() {
+  TileCache &cache = TileCache::instance();
+
+  QDialog *dialog = new QDialog();
+  dialog->setWindowTitle(tr("Tile cache"));
+
+  // Бюджет задается в мегабайтах, 0 отключает кэш.
+  QSpinBox *budgetSpinBox = new QSpinBox();
+  budgetSpinBox->setRange(0, 1 << 16);
+  budgetSpinBox->setSuffix(tr(" MB"));
+  budgetSpinBox->setValue(cache.budget() >> 20);
+
+  QLabel *noteLabel = new QLabel(tr("In use: ") +
+                                 QString::number(cache.size() >> 20) +
+                                 tr(" MB"));
+
+  QFormLayout *formLayout = new QFormLayout();
+  formLayout->addRow(tr("Memory budget:"), budgetSpinBox);
+  formLayout->addRow(noteLabel);
+
+  QDialogButtonBox *buttonBox =
+      new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+
+  connect(buttonBox, &QDialogButtonBox::accepted, dialog, &QDialog::accept);
+  connect(buttonBox, &QDialogButtonBox::rejected, dialog, &QDialog::reject);
+
+  QVBoxLayout *dialogLayout = new QVBoxLayout();
+  dialogLayout->addLayout(formLayout);
+  dialogLayout->addWidget(buttonBox);
+
+  dialog->setLayout(dialogLayout);
+  dialog->setFixedSize(dialog->sizeHint());
+
+  dialog->exec();
+
+  if (dialog->result() == QDialog::Accepted) {
+    cache.setBudget(static_cast<size_t>(budgetSpinBox->value()) << 20);
+  }
+
+  dialog->deleteLater();
+}
+
+void MainWindow::chooseQuantileAccuracy() {
+  QDialog *dialog = new QDialog();
+  dialog->setWindowTitle(tr("Quantile accuracy"));
+
+  // Сжатие дайджестов QuantileIndex, ошибка ранга около 0.05 / compression.
+  QSpinBox *compressionSpinBox = new QSpinBox();
+  compressionSpinBox->setRange(20, 5000);
+  compressionSpinBox->setSingleStep(50);
+  compressionSpinBox->setValue(
+      static_cast<int>(QuantileIndex::defaultCompression()));
+
+  QLabel *noteLabel = new QLabel();
+
+  auto updateNote = [=]() {
+    noteLabel->setText(
+        tr("Expected rank error: ") +
+        QString::number(0.05 / compressionSpinBox->value(), 'g', 2));
+  };
+  updateNote();
+
+  connect(compressionSpinBox, &QSpinBox::valueChanged, dialog, updateNote);
+
+  QFormLayout *formLayout = new QFormLayout();
+  formLayout->addRow(tr("Digest compression:"), compressionSpinBox);
+  formLayout->addRow(noteLabel);
+  formLayout->addRow(
+      new QLabel(tr("Ranges up to ") +
+                 QString::number(QuantileIndex::exactLimit) +
+                 tr(" samples are computed exactly.")));
+
+  QDialogButtonBox *buttonBox =
+      new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+
+  connect(buttonBox, &QDialogButtonBox::accepted, dialog, &QDialog::accept);
+  connect(buttonBox, &QDialogButtonBox::rejected, dialog, &QDialog::reject);
+
+  QVBoxLayout *dialogLayout = new QVBoxLayout();
+  dialogLayout->addLayout(formLayout);
+  dialogLayout->addWidget(buttonBox);
+
+  dialog->setLayout(dialogLayout);
+  dialog->setFixedSize(dialog->sizeHint());
+
+  dialog->exec();
+
+  // Индексы каналов перестраиваются с новой точностью при следующем запросе.
+  if (dialog->result() == QDialog::Accepted) {
+    QuantileIndex::setDefaultCompression(compressionSpinBox->value());
+  }
+
+  dialog->deleteLater();
+}
+
+void MainWindow::createStatusBar() {
+  m_jobLabel = new QLabel();
+
+  m_jobProgressBar = new QProgressBar();
+  m_jobProgressBar->setRange(0, 100);
+  m_jobProgressBar->setMaximumWidth(200);
+
+  m_jobCancelButton = new QPushButton(tr("Cancel"));
+  connect(m_jobCancelButton, &QPushButton::clicked, this, []() {
+    const std::vector<std::shared_ptr<Job>> &jobs =
+        JobManager::instance().jobs();
+    if (!jobs.empty()) jobs.back()->cancel();
+  });
+
+  statusBar()->addPermanentWidget(m_jobLabel);
+  statusBar()->addPermanentWidget(m_jobProgressBar);
+  statusBar()->addPermanentWidget(m_jobCancelButton);
+
+  JobManager &manager = JobManager::instance();
+  connect(&manager, &JobManager::jobsChanged, this, &MainWindow::onJobsChanged);
+  connect(&manager, &JobManager::progressChanged, this,
+          &MainWindow::onJobsProgressChanged);
+  connect(&manager, &JobManager::failed, this, &MainWindow::onJobFailed);
+
+  onJobsChanged();
+}
+
+void MainWindow::onJobsChanged() {
+  const std::vector<std::shared_ptr<Job>> &jobs =
+      JobManager::instance().jobs();
+
+  m_jobLabel->setVisible(!jobs.empty());
+  m_jobProgressBar->setVisible(!jobs.empty());
+  m_jobCancelButton->setVisible(!jobs.empty());
+
+  if (jobs.empty()) return;
+
+  QString text = jobs.back()->title();
+  if (jobs.size() > 1) {
+    text += tr(" (and %1 more)").arg(jobs.size() - 1);
+  }
+  m_jobLabel->setText(text);
+
+  onJobsProgressChanged();
+}
+
+void MainWindow::onJobsProgressChanged() {
+  const std::vector<std::shared_ptr<Job>> &jobs =
+      JobManager::instance().jobs();
+  if (jobs.empty()) return;
+
+  m_jobProgressBar->setValue(100 * jobs.back()->progress());
+}
+
+void MainWindow::onJobFailed(const QString &title, const QString &message) {
+  statusBar()->showMessage(title + ": " + message, 5000);
+}
+
 }  // namespace fssp
@@ -3,12 +3,19 @@
 #include <QCheckBox>
 #include <QDialogButtonBox>
 #include <QFileDialog>
+#include <QFormLayout>
 #include <QMainWindow>
 #include <QMenuBar>
 #include <QMessageBox>
+#include <QProgressBar>
+#include <QPushButton>
 #include <QString>
 
+#include "job.h"
+#include "jobspanel.h"
+#include "pipeline.h"
 #include "signalbuilder.h"
+#include "statistictablewindow.h"
 #include "statisticwindow.h"
 
 namespace fssp {
@@ -30,13 +37,36 @@ class MainWindow : public QMainWindow {
   void modNewSignal();
   void modInCurSignal();
   void chooseStatisticSignal();
+  void showStatisticTable();
+  void rollingStatistics();
   void spectrumAnalize();
+  void resample();
+  void rankFilter();
+  void applyPipeline();
+  void importChannel();
+  void deriveChannel();
+  void chooseThreadsNumber();
+  void chooseTileCacheBudget();
+  void chooseQuantileAccuracy();
+
+  void onJobsChanged();
+  void onJobsProgressChanged();
+  void onJobFailed(const QString &title, const QString &message);
 
  private:
   void createActions();
   void createMenus();
+  void createStatusBar();
+
+  // Выполняется в пуле потоков, поэтому работает только с аргументами.
+  static void saveSignal(
+      const SignalData &signalData,
+      const std::vector<std::shared_ptr<const ChannelSource>> &channels,
+      const std::vector<QString> &channelsName, int from, int to,
+      const QString &fileName, Job &job);
 
   QString m_lastDir;
+  Pipeline m_pipeline;
   QTabWidget *m_tabWidget;
 
   QMenu *m_fileMenu;
@@ -53,7 +83,24 @@ class MainWindow : public QMainWindow {
   QAction *m_modNewSignalAct;
   QAction *m_modInCurSignalAct;
   QAction *m_statisticAct;
+  QAction *m_statisticTableAct;
+  QAction *m_rollingStatisticsAct;
+  QAction *m_threadsNumberAct;
+  QAction *m_tileCacheAct;
+  QAction *m_quantileAccuracyAct;
   QAction *m_spectrumAnalizeAct;
+  QAction *m_resampleAct;
+  QAction *m_rankFilterAct;
+  QAction *m_pipelineAct;
+  QAction *m_importChannelAct;
+  QAction *m_deriveChannelAct;
+
+  // Последняя запущенная операция в строке состояния.
+  QLabel *m_jobLabel;
+  QProgressBar *m_jobProgressBar;
+  QPushButton *m_jobCancelButton;
+
+  JobsPanel *m_jobsPanel;
 };
 
 }  // namespace fssp
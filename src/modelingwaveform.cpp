@@ -14,12 +14,7 @@ ModelingWaveform::ModelingWaveform(std::shared_ptr<SignalData> signalData,
   setOffset(p_maxAxisTextWidth, 15, p_maxTextHeight + 5, 10);
   setPadding(3, 3, 3, 3);
 
-  p_data = p_signalData->data()[p_number];
-
-  p_leftArray = p_signalData->leftArray();
-  p_rightArray = p_signalData->rightArray();
-
-  p_arrayRange = p_rightArray - p_leftArray + 1;
+  loadEnvelope();
 
   p_minValue = *std::min_element(p_data.begin(), p_data.end());
   p_maxValue = *std::max_element(p_data.begin(), p_data.end());
@@ -29,14 +24,13 @@ ModelingWaveform::ModelingWaveform(std::shared_ptr<SignalData> signalData,
   updateRelative();
 }
 
-void ModelingWaveform::drawWaveform() {
+void ModelingWaveform::renderWaveform() {
   initImage();
   fill();
   drawAxisX();
   drawAxisY();
   drawGrid();
   drawBresenham();
-  showWaveform();
 }
 
 void ModelingWaveform::updateRelative() {
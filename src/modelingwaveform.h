@@ -13,10 +13,11 @@ class ModelingWaveform : public BaseWaveform {
   explicit ModelingWaveform(std::shared_ptr<SignalData> signalData,
                             QWidget *parent = nullptr);
 
-  void drawWaveform() override;
-
   void updateRelative();
 
+ protected:
+  void renderWaveform() override;
+
  private:
   void drawAxisX();
   void drawAxisY();
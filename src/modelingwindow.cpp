@@ -1,8 +1,15 @@
 #include "modelingwindow.h"
 
+#include <QDialogButtonBox>
 #include <QGroupBox>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPointer>
 #include <QPushButton>
+#include <QRegularExpression>
+#include <cmath>
 
+#include "job.h"
 #include "modelingwaveform.h"
 #include "signalmodels.h"
 
@@ -32,14 +39,26 @@ ModelingWindow::ModelingWindow(std::shared_ptr<SignalData> signalData,
   m_comboBox->addItem(tr("White noise model"));
   m_comboBox->addItem(tr("Normal white noise model"));
   m_comboBox->addItem(tr("Moving average autoregress model"));
+  m_comboBox->addItem(tr("Formula"));
 
   connect(m_comboBox, &QComboBox::currentIndexChanged, this,
           &ModelingWindow::onComboBoxChange);
 
+  m_previewTimer = new QTimer(this);
+  m_previewTimer->setSingleShot(true);
+  m_previewTimer->setInterval(150);
+  connect(m_previewTimer, &QTimer::timeout, this,
+          &ModelingWindow::startPreview);
+
+  m_preview = new ModelPreview(this);
+  connect(m_preview, &ModelPreview::ready, this,
+          &ModelingWindow::showPreview);
+
   m_model = new DelayedSingleImpulseModel(p_signalData);
   if (m_isHeaderLocked) {
     m_model->lockHeader();
   }
+  connectModel();
 
   m_formScrollArea = new QScrollArea();
   m_formScrollArea->setFrameShape(QFrame::NoFrame);
@@ -50,13 +69,22 @@ ModelingWindow::ModelingWindow(std::shared_ptr<SignalData> signalData,
   connect(calculateButton, &QPushButton::clicked, this,
           &ModelingWindow::onCalcButtonPress);
 
+  QPushButton *sweepButton = new QPushButton(tr("Sweep..."));
+  connect(sweepButton, &QPushButton::clicked, this,
+          &ModelingWindow::onSweepButtonPress);
+
+  QHBoxLayout *calcLayout = new QHBoxLayout();
+  calcLayout->addStretch();
+  calcLayout->addWidget(calculateButton);
+  calcLayout->addWidget(sweepButton);
+  calcLayout->addStretch();
+
   QVBoxLayout *formLayout = new QVBoxLayout();
   formLayout->addWidget(m_comboBox);
   formLayout->addSpacing(10);
   formLayout->addWidget(m_formScrollArea);
   formLayout->addSpacing(10);
-  formLayout->addWidget(calculateButton);
-  formLayout->setAlignment(calculateButton, Qt::AlignCenter);
+  formLayout->addLayout(calcLayout);
 
   formGroupBox->setLayout(formLayout);
   formGroupBox->setMaximumHeight(350);
@@ -65,21 +93,7 @@ ModelingWindow::ModelingWindow(std::shared_ptr<SignalData> signalData,
   m_previewScrollArea->setFrameShape(QFrame::NoFrame);
   m_previewScrollArea->setWidgetResizable(true);
 
-  m_model->calc();
-  std::shared_ptr<SignalData> modelSignalData =
-      std::make_shared<SignalData>(std::move(m_model->getData()));
-
-  ModelingWaveform *waveform = new ModelingWaveform(modelSignalData);
-  waveform->drawWaveform();
-
-  QVBoxLayout *waveformLayout = new QVBoxLayout();
-  waveformLayout->addWidget(waveform);
-  waveformLayout->setAlignment(waveform, Qt::AlignCenter);
-
-  QWidget *scrollWigdet = new QWidget();
-  scrollWigdet->setLayout(waveformLayout);
-
-  m_previewScrollArea->setWidget(scrollWigdet);
+  startPreview();
 
   QGroupBox *previewGroupBox = new QGroupBox(tr("Preview"));
   QVBoxLayout *previewLayout = new QVBoxLayout();
@@ -118,7 +132,148 @@ ModelingWindow::ModelingWindow(std::shared_ptr<SignalData> signalData,
   setMinimumHeight(800);
 }
 
-SignalData ModelingWindow::getData() const { return m_model->getData(); }
+SignalData ModelingWindow::getData() const {
+  if (m_sweepData) return *m_sweepData;
+
+  return m_model->getData();
+}
+
+namespace {
+
+// Значения параметра: список "1, 2, 5" или диапазон "начало:шаг:конец".
+// Пустая строка — текущее значение. При ошибке, в том числе когда значений
+// больше maxCount, возвращает false.
+bool parseSweepValues(const QString &text, size_t maxCount,
+                      std::vector<double> &values) {
+  static QRegularExpression separatorRegex("[,;\\s]+");
+
+  values.clear();
+
+  QString input = text.trimmed();
+  if (input.isEmpty()) return true;
+
+  bool ok = true;
+
+  QStringList range = input.split(':');
+  if (range.size() == 3) {
+    double start = range[0].trimmed().toDouble(&ok);
+    if (!ok || !std::isfinite(start)) return false;
+    double step = range[1].trimmed().toDouble(&ok);
+    if (!ok || !std::isfinite(step)) return false;
+    double stop = range[2].trimmed().toDouble(&ok);
+    if (!ok || !std::isfinite(stop)) return false;
+
+    if (step == 0 || (stop - start) / step < 0) return false;
+
+    // Число значений считается в double, чтобы огромный диапазон не
+    // переполнил size_t.
+    double count = std::floor((stop - start) / step + 1e-9) + 1;
+    if (!(count <= maxCount)) return false;
+
+    for (size_t i = 0; i < count; ++i) values.push_back(start + i * step);
+
+    return true;
+  }
+
+  if (range.size() != 1) return false;
+
+  QStringList list = input.split(separatorRegex, Qt::SkipEmptyParts);
+  if (static_cast<size_t>(list.size()) > maxCount) return false;
+
+  for (const QString &value : list) {
+    values.push_back(value.toDouble(&ok));
+    if (!ok || !std::isfinite(values.back())) return false;
+  }
+
+  return true;
+}
+
+}  // namespace
+
+void ModelingWindow::onSweepButtonPress() {
+  QString error = m_model->errorString();
+  if (!error.isEmpty()) {
+    QMessageBox::information(this, tr("Error"), error, QMessageBox::Ok);
+    return;
+  }
+
+  std::vector<QString> names = m_model->parametersName();
+  if (names.empty()) {
+    QMessageBox::information(this, tr("Error"),
+                             tr("The model has no numeric parameters"),
+                             QMessageBox::Ok);
+    return;
+  }
+
+  QDialog *dialog = new QDialog(this);
+  dialog->setWindowTitle(tr("Parameter sweep"));
+
+  QFormLayout *formLayout = new QFormLayout();
+  std::vector<QLineEdit *> lineEdits;
+  for (const QString &name : names) {
+    QLineEdit *lineEdit = new QLineEdit();
+    lineEdit->setPlaceholderText(tr("current value"));
+    lineEdits.push_back(lineEdit);
+
+    formLayout->addRow(name + ":", lineEdit);
+  }
+
+  QLabel *noteLabel =
+      new QLabel(tr("A list of values (1, 2, 5) or a range (start:step:stop)"));
+
+  QDialogButtonBox *buttonBox =
+      new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+
+  connect(buttonBox, &QDialogButtonBox::accepted, dialog, &QDialog::accept);
+  connect(buttonBox, &QDialogButtonBox::rejected, dialog, &QDialog::reject);
+
+  QVBoxLayout *dialogLayout = new QVBoxLayout();
+  dialogLayout->addWidget(noteLabel);
+  dialogLayout->addLayout(formLayout);
+  dialogLayout->addWidget(buttonBox);
+
+  dialog->setLayout(dialogLayout);
+
+  while (dialog->exec() == QDialog::Accepted) {
+    std::vector<std::vector<double>> values(names.size());
+
+    // Произведение в double не переполняется при любом числе параметров.
+    double sweepSize = 1;
+    bool ok = true;
+    for (size_t i = 0; i < names.size() && ok; ++i) {
+      ok = parseSweepValues(lineEdits[i]->text(), m_maxSweepSize, values[i]);
+      sweepSize *= std::max<size_t>(1, values[i].size());
+    }
+
+    if (!ok) {
+      QMessageBox::information(
+          dialog, tr("Error"),
+          tr("Wrong parameter values (at most %1 per parameter)")
+              .arg(m_maxSweepSize),
+          QMessageBox::Ok);
+      continue;
+    }
+
+    if (sweepSize > m_maxSweepSize) {
+      QMessageBox::information(
+          dialog, tr("Error"),
+          tr("Too many channels: %1 (at most %2)")
+              .arg(sweepSize, 0, 'g', 15)
+              .arg(m_maxSweepSize),
+          QMessageBox::Ok);
+      continue;
+    }
+
+    m_preview->cancel();
+    m_sweepData = std::make_shared<SignalData>(m_model->getSweepData(values));
+
+    dialog->deleteLater();
+    accept();
+    return;
+  }
+
+  dialog->deleteLater();
+}
 
 void ModelingWindow::onComboBoxChange(int index) {
   switch (index) {
@@ -174,22 +329,43 @@ void ModelingWindow::onComboBoxChange(int index) {
       m_model = new MovingAverageAutoregressModel(p_signalData);
       break;
     }
+    case 13: {
+      m_model = new FormulaModel(p_signalData);
+      break;
+    }
   }
 
   if (m_isHeaderLocked) {
     m_model->lockHeader();
   }
+  connectModel();
 
   m_formScrollArea->setWidget(m_model);
+
+  startPreview();
+}
+
+void ModelingWindow::connectModel() {
+  connect(m_model, &BaseModel::changed, m_previewTimer,
+          qOverload<>(&QTimer::start));
 }
 
 void ModelingWindow::onCalcButtonPress() {
   m_model->updateChannelName();
-  m_model->calc();
-  std::shared_ptr<SignalData> modelSignalData =
-      std::make_shared<SignalData>(std::move(m_model->getData()));
+  startPreview();
+}
+
+void ModelingWindow::startPreview() {
+  m_previewTimer->stop();
+  m_preview->start(m_model->previewTask(m_previewColumns));
+}
 
-  ModelingWaveform *waveform = new ModelingWaveform(modelSignalData);
+void ModelingWindow::showPreview(BaseModel::Preview preview) {
+  // Вычисленный для предпросмотра канал не придется считать при
+  // добавлении.
+  m_model->setChannel(preview.version, preview.channel);
+
+  ModelingWaveform *waveform = new ModelingWaveform(preview.data);
   waveform->drawWaveform();
 
   QVBoxLayout *waveformLayout = new QVBoxLayout();
@@ -203,8 +379,38 @@ void ModelingWindow::onCalcButtonPress() {
 }
 
 void ModelingWindow::onAddButtonPress() {
-  m_model->calc();
-  accept();
+  QString error = m_model->errorString();
+  if (!error.isEmpty()) {
+    QMessageBox::information(this, tr("Error"), error, QMessageBox::Ok);
+    return;
+  }
+
+  m_preview->cancel();
+
+  if (!m_model->needsComputation()) {
+    m_model->update();
+    accept();
+    return;
+  }
+
+  // Предпросмотр еще не вычислил канал: он вычисляется в фоне, окно
+  // закрывается, когда канал готов и параметры с тех пор не изменились.
+  BaseModel::Computation computation = m_model->computation();
+  QPointer<BaseModel> model = m_model;
+  int version = m_model->version();
+
+  JobManager::instance().run<std::shared_ptr<const ChannelSource>>(
+      windowTitle(), QString::number(reinterpret_cast<quintptr>(this)), this,
+      [computation](Job &job) -> std::shared_ptr<const ChannelSource> {
+        std::vector<double> data = computation(job.cancelled());
+        job.check();
+
+        return std::make_shared<StoredChannel>(std::move(data));
+      },
+      [this, model, version](std::shared_ptr<const ChannelSource> channel) {
+        if (model != m_model) return;
+        if (m_model->setChannel(version, std::move(channel))) accept();
+      });
 }
 
 void ModelingWindow::onCancelButtonPress() { reject(); }
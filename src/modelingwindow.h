@@ -3,9 +3,11 @@
 #include <QComboBox>
 #include <QDialog>
 #include <QScrollArea>
+#include <QTimer>
 #include <QWidget>
 
 #include "basemodel.h"
+#include "modelpreview.h"
 
 namespace fssp {
 
@@ -20,10 +22,16 @@ class ModelingWindow : public QDialog {
  protected slots:
   void onComboBoxChange(int index);
   void onCalcButtonPress();
+  void onSweepButtonPress();
   void onAddButtonPress();
   void onCancelButtonPress();
 
+  void startPreview();
+  void showPreview(BaseModel::Preview preview);
+
  private:
+  void connectModel();
+
   std::shared_ptr<SignalData> p_signalData;
 
   BaseModel *m_model;
@@ -33,7 +41,18 @@ class ModelingWindow : public QDialog {
 
   QScrollArea *m_previewScrollArea;
 
+  // Предпросмотр пересчитывается после паузы в изменении параметров.
+  QTimer *m_previewTimer;
+  ModelPreview *m_preview;
+
+  const int m_previewColumns = 900;
+
   bool m_isHeaderLocked;
+
+  // Результат перебора параметров, если модель добавляется перебором.
+  std::shared_ptr<SignalData> m_sweepData;
+
+  const size_t m_maxSweepSize = 1000;
 };
 
 }  // namespace fssp
@@ -0,0 +1,50 @@
+#include "modelpreview.h"
+
+#include "scheduler.h"
+
+namespace fssp {
+
+ModelPreview::ModelPreview(QObject *parent) : QObject{parent} {}
+
+ModelPreview::~ModelPreview() { cancel(); }
+
+void ModelPreview::start(BaseModel::PreviewTask task) {
+  cancel();
+
+  std::shared_ptr<State> state = std::make_shared<State>();
+  state->owner = this;
+  m_state = state;
+
+  Scheduler::instance().submit(
+      [task, state]() {
+        if (state->cancelled) return;
+
+        BaseModel::Preview preview = task(state->cancelled);
+        if (!preview.data) return;
+
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->owner) return;
+
+        // Результат создан в рабочем потоке и передается потоку окна.
+        ModelPreview *owner = state->owner;
+        preview.data->moveToThread(owner->thread());
+
+        QMetaObject::invokeMethod(
+            owner,
+            [owner, preview, state]() {
+              if (!state->cancelled) emit owner->ready(preview);
+            },
+            Qt::QueuedConnection);
+      },
+      Scheduler::Interactive);
+}
+
+void ModelPreview::cancel() {
+  if (!m_state) return;
+
+  std::lock_guard<std::mutex> lock(m_state->mutex);
+  m_state->cancelled = true;
+  m_state->owner = nullptr;
+}
+
+}  // namespace fssp
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QObject>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "basemodel.h"
+
+namespace fssp {
+
+// Вычисляет предпросмотр модели в общем пуле потоков. Новая задача отменяет
+// предыдущую, результат отмененной задачи не передается.
+class ModelPreview : public QObject {
+  Q_OBJECT
+ public:
+  explicit ModelPreview(QObject *parent = nullptr);
+  ~ModelPreview();
+
+  void start(BaseModel::PreviewTask task);
+
+  void cancel();
+
+ signals:
+  void ready(BaseModel::Preview preview);
+
+ private:
+  // Общее с задачей состояние. Отмена не ждет задачу: та проверяет флаг
+  // между блоками и не обращается к окну после отмены.
+  struct State {
+    std::atomic<bool> cancelled{false};
+
+    std::mutex mutex;
+    ModelPreview *owner;
+  };
+
+  std::shared_ptr<State> m_state;
+};
+
+}  // namespace fssp
@@ -0,0 +1,103 @@
+#include "momentindex.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "parallel.h"
+
+namespace fssp {
+
+MomentIndex::MomentIndex(const ChannelSource &channel) {
+  m_size = channel.size();
+
+  size_t blocksNumber = (m_size + blockSize - 1) / blockSize;
+  m_blocksNumber = blocksNumber;
+  m_tree = std::vector<Moments>(2 * blocksNumber);
+
+  // Блоки читаются группами, чтобы не вызывать чтение канала на каждые
+  // blockSize отсчетов.
+  constexpr size_t groupSize = 16;
+  size_t groupsNumber = (blocksNumber + groupSize - 1) / groupSize;
+
+  Moments *blocks = m_tree.data() + blocksNumber;
+  auto readGroup = [&](size_t group) {
+    size_t first = group * groupSize;
+    size_t last = std::min(blocksNumber, first + groupSize);
+
+    size_t from = first * blockSize;
+    size_t to = std::min(m_size, last * blockSize);
+
+    std::vector<double> samples;
+    const double *data = channel.samples();
+    if (data) {
+      data += from;
+    } else {
+      samples.resize(to - from);
+      channel.read(from, to - from, samples.data());
+      data = samples.data();
+    }
+
+    for (size_t i = first; i < last; ++i) {
+      size_t offset = (i - first) * blockSize;
+      blocks[i].add(data + offset, std::min(blockSize, to - from - offset));
+    }
+  };
+
+  // Индекс строится впрок и уступает потоки отрисовке.
+  parallelFor(0, groupsNumber, readGroup, Scheduler::Background);
+
+  for (size_t i = blocksNumber; i-- > 1;) {
+    m_tree[i] = m_tree[2 * i];
+    m_tree[i].merge(m_tree[2 * i + 1]);
+  }
+}
+
+Moments MomentIndex::scan(const ChannelSource &channel, size_t start,
+                          size_t count) {
+  Moments moments;
+  if (!count) return moments;
+
+  if (const double *samples = channel.samples()) {
+    moments.add(samples + start, count);
+    return moments;
+  }
+
+  std::vector<double> block(count);
+  channel.read(start, count, block.data());
+  moments.add(block.data(), count);
+
+  return moments;
+}
+
+Moments MomentIndex::moments(const ChannelSource &channel, size_t start,
+                             size_t count) const {
+  size_t end = start + count;
+
+  size_t first = (start + blockSize - 1) / blockSize;
+  size_t last = end / blockSize;
+
+  // Диапазон не содержит целых блоков.
+  if (first >= last) return scan(channel, start, count);
+
+  // Объединение не коммутативно по округлению, поэтому идет слева
+  // направо: левые узлы сразу добавляются к result, правые собираются и
+  // добавляются в обратном порядке, за ними правый неполный блок.
+  Moments result = scan(channel, start, first * blockSize - start);
+  Moments right = scan(channel, last * blockSize, end - last * blockSize);
+
+  std::vector<const Moments *> rightNodes;
+  for (size_t l = first + m_blocksNumber, r = last + m_blocksNumber; l < r;
+       l /= 2, r /= 2) {
+    if (l & 1) result.merge(m_tree[l++]);
+    if (r & 1) rightNodes.push_back(&m_tree[--r]);
+  }
+
+  for (auto node = rightNodes.rbegin(); node != rightNodes.rend(); ++node) {
+    result.merge(**node);
+  }
+  result.merge(right);
+
+  return result;
+}
+
+}  // namespace fssp
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "channelsource.h"
+#include "moments.h"
+
+namespace fssp {
+
+// Моменты блоков канала в дереве отрезков. Моменты любого диапазона
+// объединяются по формулам Пебэя из O(log n) узлов для целых блоков и
+// чтения не более двух неполных блоков на краях, поэтому их можно
+// пересчитывать при каждом движении мыши. В отличие от разности
+// префиксных сумм, точность не зависит от того, насколько среднее
+// диапазона далеко от среднего канала.
+class MomentIndex {
+ public:
+  static constexpr size_t blockSize = 4096;
+
+  // Читает канал целиком, блоки обрабатываются параллельно.
+  explicit MomentIndex(const ChannelSource &channel);
+
+  // Моменты отсчетов [start, start + count) того же канала.
+  Moments moments(const ChannelSource &channel, size_t start,
+                  size_t count) const;
+
+ private:
+  static Moments scan(const ChannelSource &channel, size_t start,
+                      size_t count);
+
+  size_t m_size;
+  size_t m_blocksNumber;
+
+  // m_tree[m_blocksNumber + i] - моменты блока i, m_tree[i] - объединение
+  // m_tree[2 * i] и m_tree[2 * i + 1].
+  std::vector<Moments> m_tree;
+};
+
+}  // namespace fssp
@@ -0,0 +1,151 @@
+#include "moments.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace fssp {
+
+void Moments::add(double value) {
+  double n1 = m_count;
+  double n = ++m_count;
+
+  double delta = value - m_mean;
+  double deltaN = delta / n;
+  double deltaN2 = deltaN * deltaN;
+  double term = delta * deltaN * n1;
+
+  m_mean += deltaN;
+  m_m4 += term * deltaN2 * (n * n - 3 * n + 3) + 6 * deltaN2 * m_m2 -
+          4 * deltaN * m_m3;
+  m_m3 += term * deltaN * (n - 2) - 3 * deltaN * m_m2;
+  m_m2 += term;
+
+  m_min = std::min(m_min, value);
+  m_max = std::max(m_max, value);
+}
+
+void Moments::add(const double *data, size_t count) {
+  for (size_t done = 0; done < count; done += blockSize) {
+    addBlock(data + done, std::min(blockSize, count - done));
+  }
+}
+
+void Moments::addBlock(const double *data, size_t count) {
+  if (!count) return;
+
+  // Несколько независимых сумм, чтобы цикл векторизовался и не ждал
+  // результата предыдущего сложения.
+  constexpr size_t lanes = 4;
+
+  double sum[lanes] = {};
+  double min[lanes];
+  double max[lanes];
+  std::fill(min, min + lanes, data[0]);
+  std::fill(max, max + lanes, data[0]);
+
+  size_t body = count - count % lanes;
+  for (size_t i = 0; i < body; i += lanes) {
+    for (size_t k = 0; k < lanes; ++k) {
+      double x = data[i + k];
+      sum[k] += x;
+      min[k] = x < min[k] ? x : min[k];
+      max[k] = x > max[k] ? x : max[k];
+    }
+  }
+  for (size_t i = body; i < count; ++i) {
+    sum[0] += data[i];
+    min[0] = std::min(min[0], data[i]);
+    max[0] = std::max(max[0], data[i]);
+  }
+
+  Moments block;
+  block.m_count = count;
+  block.m_mean = (sum[0] + sum[1] + sum[2] + sum[3]) / count;
+  block.m_min = *std::min_element(min, min + lanes);
+  block.m_max = *std::max_element(max, max + lanes);
+
+  // Блок уже в кэше, второй проход по нему не обращается к памяти.
+  double m2[lanes] = {};
+  double m3[lanes] = {};
+  double m4[lanes] = {};
+  for (size_t i = 0; i < body; i += lanes) {
+    for (size_t k = 0; k < lanes; ++k) {
+      double d = data[i + k] - block.m_mean;
+      double d2 = d * d;
+      m2[k] += d2;
+      m3[k] += d2 * d;
+      m4[k] += d2 * d2;
+    }
+  }
+  for (size_t i = body; i < count; ++i) {
+    double d = data[i] - block.m_mean;
+    double d2 = d * d;
+    m2[0] += d2;
+    m3[0] += d2 * d;
+    m4[0] += d2 * d2;
+  }
+
+  block.m_m2 = m2[0] + m2[1] + m2[2] + m2[3];
+  block.m_m3 = m3[0] + m3[1] + m3[2] + m3[3];
+  block.m_m4 = m4[0] + m4[1] + m4[2] + m4[3];
+
+  merge(block);
+}
+
+void Moments::merge(const Moments &that) {
+  if (!that.m_count) return;
+  if (!m_count) {
+    *this = that;
+    return;
+  }
+
+  double na = m_count;
+  double nb = that.m_count;
+  double n = na + nb;
+
+  double delta = that.m_mean - m_mean;
+  double deltaN = delta / n;
+  double deltaN2 = deltaN * deltaN;
+
+  double m2 = m_m2 + that.m_m2 + delta * deltaN * na * nb;
+
+  double m3 = m_m3 + that.m_m3 + delta * deltaN2 * na * nb * (na - nb) +
+              3 * deltaN * (na * that.m_m2 - nb * m_m2);
+
+  double m4 = m_m4 + that.m_m4 +
+              delta * deltaN2 * deltaN * na * nb *
+                  (na * na - na * nb + nb * nb) +
+              6 * deltaN2 * (na * na * that.m_m2 + nb * nb * m_m2) +
+              4 * deltaN * (na * that.m_m3 - nb * m_m3);
+
+  m_count += that.m_count;
+  m_mean += nb * deltaN;
+  m_m2 = m2;
+  m_m3 = m3;
+  m_m4 = m4;
+
+  m_min = std::min(m_min, that.m_min);
+  m_max = std::max(m_max, that.m_max);
+}
+
+size_t Moments::count() const { return m_count; }
+
+double Moments::min() const { return m_min; }
+
+double Moments::max() const { return m_max; }
+
+double Moments::mean() const { return m_mean; }
+
+double Moments::dispersion() const { return m_count ? m_m2 / m_count : 0; }
+
+double Moments::standardDeviation() const { return std::sqrt(dispersion()); }
+
+double Moments::asymmetry() const {
+  return std::sqrt(static_cast<double>(m_count)) * m_m3 / std::pow(m_m2, 1.5);
+}
+
+double Moments::kurtosis() const {
+  return m_count * m_m4 / (m_m2 * m_m2) - 3;
+}
+
+}  // namespace fssp
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+namespace fssp {
+
+// Минимум, максимум, среднее и центральные моменты до 4-го порядка за один
+// проход по данным. Частичные моменты разных частей объединяются по
+// формулам Пебэя, поэтому части можно считать параллельно.
+class Moments {
+ public:
+  void add(double value);
+  void add(const double *data, size_t count);
+
+  void merge(const Moments &that);
+
+  size_t count() const;
+
+  double min() const;
+  double max() const;
+  double mean() const;
+
+  double dispersion() const;
+  double standardDeviation() const;
+
+  double asymmetry() const;
+  double kurtosis() const;
+
+ private:
+  // Моменты блока, помещающегося в кэш: среднее, затем центральные суммы.
+  void addBlock(const double *data, size_t count);
+
+  static constexpr size_t blockSize = 2048;
+
+  size_t m_count = 0;
+
+  double m_min = std::numeric_limits<double>::infinity();
+  double m_max = -std::numeric_limits<double>::infinity();
+  double m_mean = 0;
+
+  // Суммы степеней отклонений от среднего.
+  double m_m2 = 0;
+  double m_m3 = 0;
+  double m_m4 = 0;
+};
+
+}  // namespace fssp
@@ -50,8 +50,9 @@ void NavigationDialog::addWaveforms() {
 }
 
 void NavigationDialog::drawWaveforms() {
+  // Кадры каналов рисуются параллельно в общем пуле потоков.
   for (int i = 0; i < m_waveforms.size(); ++i) {
-    m_waveforms[i]->drawWaveform();
+    m_waveforms[i]->scheduleWaveform();
   }
 }
 
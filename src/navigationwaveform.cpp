@@ -12,28 +12,34 @@ NavigationWaveform::NavigationWaveform(std::shared_ptr<SignalData> signalData,
 
   setTextMargin(5, 5, 3, 3);
   setOffset(0, 0, 0, p_maxTextHeight);
+}
 
-  p_data = p_signalData->data()[p_number];
+NavigationWaveform::~NavigationWaveform() { stopRendering(); }
 
-  p_leftArray = p_signalData->leftArray();
-  p_rightArray = p_signalData->rightArray();
+void NavigationWaveform::prepareWaveform() {
+  BaseWaveform::prepareWaveform();
 
-  p_arrayRange = p_rightArray - p_leftArray + 1;
+  onChangedGraphTimeRange();
+}
 
-  p_minValue = *std::min_element(p_data.begin(), p_data.end());
-  p_maxValue = *std::max_element(p_data.begin(), p_data.end());
+void NavigationWaveform::renderWaveform() {
+  // Огибающая читается в первом кадре, в рабочем потоке, поэтому каналы
+  // панели загружаются параллельно.
+  if (!m_isEnvelopeLoaded) {
+    loadEnvelope();
 
-  p_dataRange = std::abs(p_maxValue - p_minValue);
-}
+    p_minValue = *std::min_element(p_data.begin(), p_data.end());
+    p_maxValue = *std::max_element(p_data.begin(), p_data.end());
+
+    p_dataRange = std::abs(p_maxValue - p_minValue);
+
+    m_isEnvelopeLoaded = true;
+  }
 
-void NavigationWaveform::drawWaveform() {
   initImage();
   fill();
   drawName();
   drawBresenham();
-  showWaveform();
-
-  onChangedGraphTimeRange();
 }
 
 void NavigationWaveform::mousePressEvent(QMouseEvent *event) {
@@ -100,7 +106,7 @@ void NavigationWaveform::drawName() {
                  p_width - (p_paddingRight + p_paddingLeft), p_maxTextHeight};
 
   painter.drawText(textRect, Qt::AlignCenter | Qt::TextWordWrap,
-                   p_signalData->channelsName()[p_number]);
+                   p_name);
 }
 
 }  // namespace fssp
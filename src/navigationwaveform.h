@@ -13,13 +13,15 @@ class NavigationWaveform : public BaseWaveform {
  public:
   explicit NavigationWaveform(std::shared_ptr<SignalData> signalData,
                               int number, QWidget *parent = nullptr);
-
-  void drawWaveform() override;
+  ~NavigationWaveform() override;
 
  public slots:
   void onChangedGraphTimeRange();
 
  protected:
+  void prepareWaveform() override;
+  void renderWaveform() override;
+
   void mousePressEvent(QMouseEvent *event) override;
   void showContextMenu(const QPoint &pos);
 
@@ -32,6 +34,7 @@ class NavigationWaveform : public BaseWaveform {
   void drawName();
 
   bool m_isVisible;
+  bool m_isEnvelopeLoaded = false;
 
   QRect m_selectionRect;
 };
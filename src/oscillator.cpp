@@ -0,0 +1,133 @@
+#include "oscillator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace fssp {
+
+Oscillator::Oscillator(double amplitude, double omega, double phase,
+                       double decay)
+    : m_amplitude{amplitude},
+      m_omega{omega},
+      m_phase{phase},
+      m_decay{decay},
+      m_re(blockSize),
+      m_im(blockSize) {
+  for (size_t j = 0; j < blockSize; ++j) {
+    double magnitude = std::exp(-decay * j);
+    m_re[j] = magnitude * std::cos(omega * j);
+    m_im[j] = magnitude * std::sin(omega * j);
+  }
+}
+
+void Oscillator::generate(double *output, size_t start, size_t count) const {
+  run<false>(output, start, count);
+}
+
+void Oscillator::accumulate(double *output, size_t start,
+                            size_t count) const {
+  run<true>(output, start, count);
+}
+
+template <bool Accumulate>
+void Oscillator::run(double *output, size_t start, size_t count) const {
+  const double *re = m_re.data();
+  const double *im = m_im.data();
+
+  for (size_t done = 0; done < count; done += blockSize) {
+    size_t n = start + done;
+    size_t length = std::min(blockSize, count - done);
+
+    double magnitude = m_amplitude;
+    if (m_decay != 0) {
+      magnitude *= std::exp(-m_decay * static_cast<double>(n));
+    }
+
+    double angle = static_cast<double>(n) * m_omega + m_phase;
+    double anchorRe = magnitude * std::cos(angle);
+    double anchorIm = magnitude * std::sin(angle);
+
+    double *block = output + done;
+    for (size_t j = 0; j < length; ++j) {
+      double value = anchorRe * re[j] - anchorIm * im[j];
+      if constexpr (Accumulate) {
+        block[j] += value;
+      } else {
+        block[j] = value;
+      }
+    }
+  }
+}
+
+//
+
+ChirpOscillator::ChirpOscillator(double amplitude, double rate, double omega,
+                                 double phase)
+    : m_amplitude{amplitude},
+      m_rate{rate},
+      m_omega{omega},
+      m_phase{phase},
+      m_re(blockSize),
+      m_im(blockSize) {
+  for (size_t j = 0; j < blockSize; ++j) {
+    double angle = rate * static_cast<double>(j * j);
+    m_re[j] = std::cos(angle);
+    m_im[j] = std::sin(angle);
+  }
+}
+
+void ChirpOscillator::generate(double *output, size_t start,
+                               size_t count) const {
+  // Внутри блока, начинающегося с s, фаза равна
+  // (rate * s^2 + omega * s + phase) + (2 * rate * s + omega) * j
+  // + rate * j^2. Линейная часть раскладывается на шаги по stepSize и
+  // остатки от деления на stepSize, квадратичная берется из таблицы.
+  double stepRe[stepSize], stepIm[stepSize];
+  double fineRe[stepSize], fineIm[stepSize];
+  double rowRe[stepSize], rowIm[stepSize];
+
+  for (size_t done = 0; done < count; done += blockSize) {
+    double s = static_cast<double>(start + done);
+    size_t length = std::min(blockSize, count - done);
+
+    double angle = (m_rate * s + m_omega) * s + m_phase;
+    double slope = 2 * m_rate * s + m_omega;
+
+    fineRe[0] = 1;
+    fineIm[0] = 0;
+    double rotationRe = std::cos(slope);
+    double rotationIm = std::sin(slope);
+    for (size_t k = 1; k < stepSize; ++k) {
+      fineRe[k] = fineRe[k - 1] * rotationRe - fineIm[k - 1] * rotationIm;
+      fineIm[k] = fineRe[k - 1] * rotationIm + fineIm[k - 1] * rotationRe;
+    }
+
+    stepRe[0] = m_amplitude * std::cos(angle);
+    stepIm[0] = m_amplitude * std::sin(angle);
+    rotationRe = std::cos(slope * stepSize);
+    rotationIm = std::sin(slope * stepSize);
+    for (size_t k = 1; k < stepSize; ++k) {
+      stepRe[k] = stepRe[k - 1] * rotationRe - stepIm[k - 1] * rotationIm;
+      stepIm[k] = stepRe[k - 1] * rotationIm + stepIm[k - 1] * rotationRe;
+    }
+
+    double *block = output + done;
+    for (size_t row = 0; row * stepSize < length; ++row) {
+      size_t offset = row * stepSize;
+      size_t rowLength = std::min(stepSize, length - offset);
+
+      for (size_t k = 0; k < stepSize; ++k) {
+        rowRe[k] = stepRe[row] * fineRe[k] - stepIm[row] * fineIm[k];
+        rowIm[k] = stepRe[row] * fineIm[k] + stepIm[row] * fineRe[k];
+      }
+
+      const double *re = m_re.data() + offset;
+      const double *im = m_im.data() + offset;
+      for (size_t k = 0; k < rowLength; ++k) {
+        block[offset + k] = rowRe[k] * re[k] - rowIm[k] * im[k];
+      }
+    }
+  }
+}
+
+}  // namespace fssp
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace fssp {
+
+// Гармоническое колебание amplitude * exp(-decay * n) * cos(omega * n + phase).
+// Значения считаются блоками: начало блока вычисляется напрямую, остальные
+// отсчеты - поворотом на заранее посчитанную таблицу. Ошибка не
+// накапливается между блоками, а внутренний цикл векторизуется.
+class Oscillator {
+ public:
+  static constexpr size_t blockSize = 256;
+
+  explicit Oscillator(double amplitude, double omega, double phase,
+                      double decay = 0);
+
+  // Записывает отсчеты [start, start + count) в output.
+  void generate(double *output, size_t start, size_t count) const;
+
+  // Прибавляет отсчеты [start, start + count) к output.
+  void accumulate(double *output, size_t start, size_t count) const;
+
+ private:
+  template <bool Accumulate>
+  void run(double *output, size_t start, size_t count) const;
+
+  double m_amplitude;
+  double m_omega;
+  double m_phase;
+  double m_decay;
+
+  std::vector<double> m_re;
+  std::vector<double> m_im;
+};
+
+// Колебание с квадратичной фазой
+// amplitude * cos(rate * n^2 + omega * n + phase).
+class ChirpOscillator {
+ public:
+  static constexpr size_t blockSize = 256;
+
+  explicit ChirpOscillator(double amplitude, double rate, double omega,
+                           double phase);
+
+  void generate(double *output, size_t start, size_t count) const;
+
+ private:
+  static constexpr size_t stepSize = 16;
+
+  double m_amplitude;
+  double m_rate;
+  double m_omega;
+  double m_phase;
+
+  // exp(i * rate * j^2) для j из [0, blockSize).
+  std::vector<double> m_re;
+  std::vector<double> m_im;
+};
+
+}  // namespace fssp
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "scheduler.h"
+
+namespace fssp {
+
+// Выполняет function(i) для i из [begin, end) в общем пуле потоков.
+template <typename Function>
+void parallelFor(size_t begin, size_t end, Function function,
+                 Scheduler::Priority priority = Scheduler::Interactive) {
+  Scheduler::instance().parallelFor(begin, end, function, priority);
+}
+
+// Свертка [begin, end): каждая часть диапазона накапливает свой результат
+// вызовами accumulate(part, i), начиная с identity, затем части
+// объединяются combine(result, part) по порядку. Разбиение зависит только
+// от длины диапазона, поэтому результат не зависит от числа потоков.
+template <typename T, typename Accumulate, typename Combine>
+T parallelReduce(size_t begin, size_t end, const T &identity,
+                 Accumulate accumulate, Combine combine,
+                 Scheduler::Priority priority = Scheduler::Interactive) {
+  if (begin >= end) return identity;
+
+  size_t count = end - begin;
+  size_t partsNumber = std::min<size_t>(count, 64);
+
+  std::vector<T> parts(partsNumber, identity);
+  parallelFor(
+      0, partsNumber,
+      [&](size_t part) {
+        size_t first = begin + count * part / partsNumber;
+        size_t last = begin + count * (part + 1) / partsNumber;
+        for (size_t i = first; i < last; ++i) accumulate(parts[part], i);
+      },
+      priority);
+
+  T result = identity;
+  for (const T &part : parts) combine(result, part);
+
+  return result;
+}
+
+}  // namespace fssp
@@ -0,0 +1,414 @@
+#include "pipeline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <memory>
+#include <sstream>
+
+#include "rankfilter.h"
+#include "resampler.h"
+
+namespace fssp {
+
+class BlockProcessor {
+ public:
+  virtual ~BlockProcessor() = default;
+
+  virtual void process(const double *input, size_t count,
+                       std::vector<double> &output) = 0;
+  virtual void flush(std::vector<double> &/*output*/) {}
+};
+
+namespace {
+
+const std::vector<Pipeline::StageType> stageTypes = {
+    Pipeline::StageType::Detrend,  Pipeline::StageType::Lowpass,
+    Pipeline::StageType::Highpass, Pipeline::StageType::Median,
+    Pipeline::StageType::Resample, Pipeline::StageType::Rectify,
+    Pipeline::StageType::Envelope, Pipeline::StageType::Decimate,
+};
+
+// Вычитание скользящего среднего по центрированному окну.
+class DetrendProcessor : public BlockProcessor {
+ public:
+  explicit DetrendProcessor(int windowSize) {
+    m_windowSize = std::max(1, windowSize);
+    m_left = (m_windowSize - 1) / 2;
+  }
+
+  void process(const double *input, size_t count,
+               std::vector<double> &output) override {
+    for (size_t i = 0; i < count; ++i) {
+      if (!m_pushed) {
+        for (int k = 0; k < m_left; ++k) push(input[i], output);
+      }
+      push(input[i], output);
+    }
+
+    if (count) m_last = input[count - 1];
+  }
+
+  void flush(std::vector<double> &output) override {
+    if (!m_pushed) return;
+
+    int right = m_windowSize - 1 - m_left;
+    for (int k = 0; k < right; ++k) push(m_last, output);
+  }
+
+ private:
+  void push(double value, std::vector<double> &output) {
+    m_window.push_back(value);
+    m_sum += value;
+    ++m_pushed;
+
+    if (m_window.size() > m_windowSize) {
+      m_sum -= m_window.front();
+      m_window.pop_front();
+    }
+
+    // Периодический пересчет суммы, чтобы не накапливалась ошибка.
+    if (m_pushed % 65536 == 0) {
+      m_sum = 0;
+      for (double x : m_window) m_sum += x;
+    }
+
+    if (m_window.size() == m_windowSize) {
+      output.push_back(m_window[m_left] - m_sum / m_windowSize);
+    }
+  }
+
+  size_t m_windowSize;
+  int m_left;
+
+  std::deque<double> m_window;
+  double m_sum = 0;
+  size_t m_pushed = 0;
+  double m_last = 0;
+};
+
+// Биквадратный фильтр Баттерворта второго порядка.
+class BiquadProcessor : public BlockProcessor {
+ public:
+  explicit BiquadProcessor(bool highpass, double cutoff, double rate,
+                           bool rectify = false) {
+    m_rectify = rectify;
+
+    double w0 = 2 * M_PI * std::clamp(cutoff / rate, 1e-9, 0.499);
+    double alpha = std::sin(w0) / (2 * M_SQRT1_2);
+    double cosw0 = std::cos(w0);
+    double a0 = 1 + alpha;
+
+    if (highpass) {
+      m_b0 = (1 + cosw0) / 2 / a0;
+      m_b1 = -(1 + cosw0) / a0;
+    } else {
+      m_b0 = (1 - cosw0) / 2 / a0;
+      m_b1 = (1 - cosw0) / a0;
+    }
+    m_b2 = m_b0;
+    m_a1 = -2 * cosw0 / a0;
+    m_a2 = (1 - alpha) / a0;
+  }
+
+  void process(const double *input, size_t count,
+               std::vector<double> &output) override {
+    size_t offset = output.size();
+    output.resize(offset + count);
+
+    double *out = output.data() + offset;
+    for (size_t i = 0; i < count; ++i) {
+      double x = m_rectify ? std::abs(input[i]) : input[i];
+      double y = m_b0 * x + m_z1;
+      m_z1 = m_b1 * x - m_a1 * y + m_z2;
+      m_z2 = m_b2 * x - m_a2 * y;
+      out[i] = y;
+    }
+  }
+
+ private:
+  bool m_rectify;
+
+  double m_b0, m_b1, m_b2;
+  double m_a1, m_a2;
+
+  double m_z1 = 0;
+  double m_z2 = 0;
+};
+
+class RectifyProcessor : public BlockProcessor {
+ public:
+  void process(const double *input, size_t count,
+               std::vector<double> &output) override {
+    size_t offset = output.size();
+    output.resize(offset + count);
+
+    double *out = output.data() + offset;
+    for (size_t i = 0; i < count; ++i) out[i] = std::abs(input[i]);
+  }
+};
+
+class MedianProcessor : public BlockProcessor {
+ public:
+  explicit MedianProcessor(int windowSize)
+      : m_filter{RankFilter::Type::Median, std::max(1, windowSize)} {}
+
+  void process(const double *input, size_t count,
+               std::vector<double> &output) override {
+    m_filter.process(input, count, output);
+  }
+
+  void flush(std::vector<double> &output) override { m_filter.flush(output); }
+
+ private:
+  RankFilter m_filter;
+};
+
+class ResampleProcessor : public BlockProcessor {
+ public:
+  explicit ResampleProcessor(int upFactor, int downFactor)
+      : m_resampler{upFactor, downFactor} {}
+
+  void process(const double *input, size_t count,
+               std::vector<double> &output) override {
+    m_resampler.process(input, count, output);
+  }
+
+  void flush(std::vector<double> &output) override {
+    m_resampler.flush(output);
+  }
+
+ private:
+  Resampler m_resampler;
+};
+
+std::unique_ptr<BlockProcessor> createProcessor(const Pipeline::Stage &stage,
+                                                double rate) {
+  const std::vector<double> &p = stage.parameters;
+
+  switch (stage.type) {
+    case Pipeline::StageType::Detrend:
+      return std::make_unique<DetrendProcessor>(std::lround(p[0]));
+    case Pipeline::StageType::Lowpass:
+      return std::make_unique<BiquadProcessor>(false, p[0], rate);
+    case Pipeline::StageType::Highpass:
+      return std::make_unique<BiquadProcessor>(true, p[0], rate);
+    case Pipeline::StageType::Median:
+      return std::make_unique<MedianProcessor>(std::lround(p[0]));
+    case Pipeline::StageType::Resample:
+      return std::make_unique<ResampleProcessor>(std::lround(p[0]),
+                                                 std::lround(p[1]));
+    case Pipeline::StageType::Rectify:
+      return std::make_unique<RectifyProcessor>();
+    case Pipeline::StageType::Envelope:
+      return std::make_unique<BiquadProcessor>(false, p[0], rate, true);
+    case Pipeline::StageType::Decimate:
+      return std::make_unique<ResampleProcessor>(1, std::lround(p[0]));
+  }
+
+  return nullptr;
+}
+
+double stageRate(const Pipeline::Stage &stage, double rate) {
+  if (stage.type == Pipeline::StageType::Resample) {
+    return rate * std::lround(stage.parameters[0]) /
+           std::lround(stage.parameters[1]);
+  }
+
+  if (stage.type == Pipeline::StageType::Decimate) {
+    return rate / std::lround(stage.parameters[0]);
+  }
+
+  return rate;
+}
+
+}  // namespace
+
+void Pipeline::addStage(Pipeline::StageType type,
+                        std::vector<double> parameters) {
+  if (static_cast<int>(parameters.size()) != parametersNumber(type)) {
+    throw Pipeline::ParseError();
+  }
+
+  int maximum = parametersMaximum(type);
+  for (double parameter : parameters) {
+    if (!std::isfinite(parameter) || parameter <= 0) {
+      throw Pipeline::InvalidParameter();
+    }
+
+    // Целые параметры должны быть целыми от 1 до maximum.
+    if (maximum && (parameter < 1 || parameter > maximum ||
+                    parameter != std::floor(parameter))) {
+      throw Pipeline::InvalidParameter();
+    }
+  }
+
+  m_stages.push_back({type, std::move(parameters)});
+}
+
+void Pipeline::removeStage(int index) {
+  m_stages.erase(m_stages.begin() + index);
+}
+
+void Pipeline::moveStage(int from, int to) {
+  Pipeline::Stage stage = m_stages[from];
+  m_stages.erase(m_stages.begin() + from);
+  m_stages.insert(m_stages.begin() + to, stage);
+}
+
+void Pipeline::clear() { m_stages.clear(); }
+
+const std::vector<Pipeline::Stage> &Pipeline::stages() const {
+  return m_stages;
+}
+
+bool Pipeline::isEmpty() const { return m_stages.empty(); }
+
+double Pipeline::outputRate(double inputRate) const {
+  double rate = inputRate;
+  for (const Pipeline::Stage &stage : m_stages) rate = stageRate(stage, rate);
+
+  return rate;
+}
+
+std::vector<double> Pipeline::run(const double *input, size_t count,
+                                  double rate) const {
+  Pipeline::Stream stream(*this, rate);
+
+  std::vector<double> result;
+  for (size_t offset = 0; offset < count; offset += blockSize) {
+    stream.process(input + offset, std::min(blockSize, count - offset),
+                   result);
+  }
+  stream.flush(result);
+
+  return result;
+}
+
+Pipeline::Stream::Stream(const Pipeline &pipeline, double rate) {
+  for (const Pipeline::Stage &stage : pipeline.m_stages) {
+    m_processors.push_back(createProcessor(stage, rate));
+    rate = stageRate(stage, rate);
+  }
+}
+
+Pipeline::Stream::~Stream() = default;
+
+void Pipeline::Stream::process(const double *input, size_t count,
+                               std::vector<double> &output) {
+  m_block.assign(input, input + count);
+
+  for (std::unique_ptr<BlockProcessor> &processor : m_processors) {
+    m_next.clear();
+    processor->process(m_block.data(), m_block.size(), m_next);
+    std::swap(m_block, m_next);
+  }
+
+  output.insert(output.end(), m_block.begin(), m_block.end());
+}
+
+void Pipeline::Stream::flush(std::vector<double> &output) {
+  // Хвосты звеньев с задержкой проталкиваются через оставшуюся цепочку.
+  m_block.clear();
+  for (std::unique_ptr<BlockProcessor> &processor : m_processors) {
+    m_next.clear();
+    if (!m_block.empty()) {
+      processor->process(m_block.data(), m_block.size(), m_next);
+    }
+    processor->flush(m_next);
+    std::swap(m_block, m_next);
+  }
+
+  output.insert(output.end(), m_block.begin(), m_block.end());
+}
+
+std::string Pipeline::toString() const {
+  std::ostringstream stream;
+  stream.precision(17);
+
+  stream << "# fssp pipeline\n";
+  for (const Pipeline::Stage &stage : m_stages) {
+    stream << stageName(stage.type);
+    for (double parameter : stage.parameters) stream << " " << parameter;
+    stream << "\n";
+  }
+
+  return stream.str();
+}
+
+Pipeline Pipeline::fromString(const std::string &text) {
+  Pipeline pipeline;
+
+  std::istringstream stream(text);
+  std::string line;
+  while (std::getline(stream, line)) {
+    std::istringstream lineStream(line);
+
+    std::string name;
+    if (!(lineStream >> name) || name[0] == '#') continue;
+
+    auto type = std::find_if(
+        stageTypes.begin(), stageTypes.end(),
+        [&](Pipeline::StageType type) { return name == stageName(type); });
+    if (type == stageTypes.end()) throw Pipeline::ParseError();
+
+    std::vector<double> parameters;
+    double parameter;
+    while (lineStream >> parameter) parameters.push_back(parameter);
+
+    if (!lineStream.eof()) throw Pipeline::ParseError();
+
+    pipeline.addStage(*type, std::move(parameters));
+  }
+
+  return pipeline;
+}
+
+const char *Pipeline::stageName(Pipeline::StageType type) {
+  switch (type) {
+    case Pipeline::StageType::Detrend:
+      return "detrend";
+    case Pipeline::StageType::Lowpass:
+      return "lowpass";
+    case Pipeline::StageType::Highpass:
+      return "highpass";
+    case Pipeline::StageType::Median:
+      return "median";
+    case Pipeline::StageType::Resample:
+      return "resample";
+    case Pipeline::StageType::Rectify:
+      return "rectify";
+    case Pipeline::StageType::Envelope:
+      return "envelope";
+    case Pipeline::StageType::Decimate:
+      return "decimate";
+  }
+
+  return "";
+}
+
+int Pipeline::parametersNumber(Pipeline::StageType type) {
+  switch (type) {
+    case Pipeline::StageType::Resample:
+      return 2;
+    case Pipeline::StageType::Rectify:
+      return 0;
+    default:
+      return 1;
+  }
+}
+
+int Pipeline::parametersMaximum(Pipeline::StageType type) {
+  switch (type) {
+    case Pipeline::StageType::Detrend:
+    case Pipeline::StageType::Median:
+      return maxWindowSize;
+    case Pipeline::StageType::Resample:
+    case Pipeline::StageType::Decimate:
+      return maxFactor;
+    default:
+      return 0;
+  }
+}
+
+}  // namespace fssp
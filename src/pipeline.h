@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fssp {
+
+class BlockProcessor;
+
+// Цепочка операций над каналом. Все звенья выполняются за один потоковый
+// проход блоками по blockSize отсчетов, в памяти целиком хранится только
+// результат последнего звена.
+class Pipeline {
+ public:
+  enum class StageType {
+    Detrend,
+    Lowpass,
+    Highpass,
+    Median,
+    Resample,
+    Rectify,
+    Envelope,
+    Decimate,
+  };
+
+  struct Stage {
+    Pipeline::StageType type;
+    std::vector<double> parameters;
+  };
+
+  static constexpr size_t blockSize = 4096;
+
+  // Окна скользящих звеньев хранятся целиком, множители передискретизации
+  // задают длину фильтра, поэтому целые параметры ограничены сверху.
+  static constexpr int maxWindowSize = 1 << 20;
+  static constexpr int maxFactor = 1000;
+
+  void addStage(Pipeline::StageType type, std::vector<double> parameters);
+  void removeStage(int index);
+  void moveStage(int from, int to);
+  void clear();
+
+  const std::vector<Pipeline::Stage> &stages() const;
+  bool isEmpty() const;
+
+  double outputRate(double inputRate) const;
+
+  std::vector<double> run(const double *input, size_t count,
+                          double rate) const;
+
+  // Потоковое выполнение цепочки: вход подается блоками в process, в конце
+  // flush выдает хвосты звеньев с задержкой.
+  class Stream {
+   public:
+    explicit Stream(const Pipeline &pipeline, double rate);
+    ~Stream();
+
+    void process(const double *input, size_t count,
+                 std::vector<double> &output);
+    void flush(std::vector<double> &output);
+
+   private:
+    std::vector<std::unique_ptr<BlockProcessor>> m_processors;
+
+    std::vector<double> m_block;
+    std::vector<double> m_next;
+  };
+
+  std::string toString() const;
+  static Pipeline fromString(const std::string &text);
+
+  static const char *stageName(Pipeline::StageType type);
+  static int parametersNumber(Pipeline::StageType type);
+  // Наибольшее значение целых параметров звена, 0 для вещественных.
+  static int parametersMaximum(Pipeline::StageType type);
+
+  class ParseError : public std::exception {
+   public:
+    virtual const char *what() const throw() {
+      return "Pipeline description is invalid";
+    }
+  };
+
+  class InvalidParameter : public std::exception {
+   public:
+    virtual const char *what() const throw() {
+      return "Stage parameter is out of range";
+    }
+  };
+
+ private:
+  std::vector<Pipeline::Stage> m_stages;
+};
+
+}  // namespace fssp
@@ -0,0 +1,329 @@
+#include "pipelinewindow.h"
+
+#include <QDialogButtonBox>
+#include <QFileDialog>
+#include <QFormLayout>
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTextStream>
+#include <QVBoxLayout>
+#include <limits>
+
+namespace fssp {
+
+PipelineWindow::PipelineWindow(std::shared_ptr<SignalData> signalData,
+                               const Pipeline &pipeline, QWidget *parent)
+    : QDialog{parent} {
+  p_signalData = signalData;
+  m_pipeline = pipeline;
+
+  setWindowTitle(tr("Pipeline"));
+
+  m_stagesList = new QListWidget();
+
+  QPushButton *removeButton = new QPushButton(tr("Remove"));
+  connect(removeButton, &QPushButton::clicked, this,
+          &PipelineWindow::onRemoveButtonPress);
+
+  QPushButton *upButton = new QPushButton(tr("Up"));
+  connect(upButton, &QPushButton::clicked, this,
+          &PipelineWindow::onUpButtonPress);
+
+  QPushButton *downButton = new QPushButton(tr("Down"));
+  connect(downButton, &QPushButton::clicked, this,
+          &PipelineWindow::onDownButtonPress);
+
+  QPushButton *loadButton = new QPushButton(tr("Load..."));
+  connect(loadButton, &QPushButton::clicked, this,
+          &PipelineWindow::onLoadButtonPress);
+
+  QPushButton *saveButton = new QPushButton(tr("Save..."));
+  connect(saveButton, &QPushButton::clicked, this,
+          &PipelineWindow::onSaveButtonPress);
+
+  QVBoxLayout *listButtonsLayout = new QVBoxLayout();
+  listButtonsLayout->addWidget(removeButton);
+  listButtonsLayout->addWidget(upButton);
+  listButtonsLayout->addWidget(downButton);
+  listButtonsLayout->addStretch();
+  listButtonsLayout->addWidget(loadButton);
+  listButtonsLayout->addWidget(saveButton);
+
+  QHBoxLayout *listLayout = new QHBoxLayout();
+  listLayout->addWidget(m_stagesList);
+  listLayout->addLayout(listButtonsLayout);
+
+  QGroupBox *stagesGroupBox = new QGroupBox(tr("Stages"));
+  stagesGroupBox->setLayout(listLayout);
+
+  m_stageComboBox = new QComboBox();
+  for (int i = 0; i <= static_cast<int>(Pipeline::StageType::Decimate); ++i) {
+    m_stageComboBox->addItem(stageTitle(static_cast<Pipeline::StageType>(i)));
+  }
+
+  connect(m_stageComboBox, &QComboBox::currentIndexChanged, this,
+          &PipelineWindow::onStageTypeChange);
+
+  m_firstParameterLabel = new QLabel();
+  m_firstParameterSpinBox = new QDoubleSpinBox();
+  m_firstParameterSpinBox->setDecimals(6);
+  m_firstParameterSpinBox->setRange(0, INT_MAX);
+
+  m_firstIntegerSpinBox = new QSpinBox();
+
+  QHBoxLayout *firstParameterLayout = new QHBoxLayout();
+  firstParameterLayout->addWidget(m_firstParameterSpinBox);
+  firstParameterLayout->addWidget(m_firstIntegerSpinBox);
+
+  m_secondParameterLabel = new QLabel();
+  m_secondIntegerSpinBox = new QSpinBox();
+
+  QPushButton *addButton = new QPushButton(tr("Add stage"));
+  connect(addButton, &QPushButton::clicked, this,
+          &PipelineWindow::onAddButtonPress);
+
+  QFormLayout *stageLayout = new QFormLayout();
+  stageLayout->addRow(tr("Stage:"), m_stageComboBox);
+  stageLayout->addRow(m_firstParameterLabel, firstParameterLayout);
+  stageLayout->addRow(m_secondParameterLabel, m_secondIntegerSpinBox);
+  stageLayout->addRow(addButton);
+
+  QGroupBox *stageGroupBox = new QGroupBox(tr("New stage"));
+  stageGroupBox->setLayout(stageLayout);
+
+  QHBoxLayout *checkBoxesLayout = new QHBoxLayout();
+  for (int i = 0; i < p_signalData->channelsNumber(); ++i) {
+    QCheckBox *checkBox = new QCheckBox(p_signalData->channelsName()[i]);
+    m_checkBoxes.push_back(checkBox);
+
+    checkBoxesLayout->addWidget(checkBox);
+  }
+
+  QGroupBox *channelsGroupBox = new QGroupBox(tr("Channels"));
+  channelsGroupBox->setLayout(checkBoxesLayout);
+
+  m_rateLabel = new QLabel();
+
+  QDialogButtonBox *buttonBox =
+      new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+
+  connect(buttonBox, &QDialogButtonBox::accepted, this, &QDialog::accept);
+  connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+  QVBoxLayout *mainLayout = new QVBoxLayout();
+  mainLayout->addWidget(stagesGroupBox);
+  mainLayout->addWidget(stageGroupBox);
+  mainLayout->addWidget(channelsGroupBox);
+  mainLayout->addWidget(m_rateLabel);
+  mainLayout->addWidget(buttonBox);
+
+  setLayout(mainLayout);
+
+  onStageTypeChange(0);
+  updateStagesList();
+
+  setMinimumWidth(500);
+}
+
+const Pipeline &PipelineWindow::pipeline() const { return m_pipeline; }
+
+std::vector<int> PipelineWindow::channels() const {
+  std::vector<int> channels;
+  for (int i = 0; i < m_checkBoxes.size(); ++i) {
+    if (m_checkBoxes[i]->isChecked()) channels.push_back(i);
+  }
+
+  return channels;
+}
+
+void PipelineWindow::onStageTypeChange(int index) {
+  Pipeline::StageType type = static_cast<Pipeline::StageType>(index);
+  QStringList titles = parametersTitle(type);
+  int maximum = Pipeline::parametersMaximum(type);
+
+  m_firstParameterLabel->setVisible(titles.size() > 0);
+  m_firstParameterSpinBox->setVisible(titles.size() > 0 && !maximum);
+  m_firstIntegerSpinBox->setVisible(titles.size() > 0 && maximum);
+  m_secondParameterLabel->setVisible(titles.size() > 1);
+  m_secondIntegerSpinBox->setVisible(titles.size() > 1);
+
+  m_firstIntegerSpinBox->setRange(1, std::max(1, maximum));
+  m_secondIntegerSpinBox->setRange(1, std::max(1, maximum));
+
+  if (titles.size() > 0) {
+    m_firstParameterLabel->setText(titles[0]);
+    m_firstParameterSpinBox->setValue(1);
+    m_firstIntegerSpinBox->setValue(1);
+  }
+
+  if (titles.size() > 1) {
+    m_secondParameterLabel->setText(titles[1]);
+    m_secondIntegerSpinBox->setValue(1);
+  }
+}
+
+void PipelineWindow::onAddButtonPress() {
+  Pipeline::StageType type =
+      static_cast<Pipeline::StageType>(m_stageComboBox->currentIndex());
+
+  std::vector<double> parameters;
+  if (Pipeline::parametersNumber(type) > 0) {
+    parameters.push_back(Pipeline::parametersMaximum(type)
+                             ? m_firstIntegerSpinBox->value()
+                             : m_firstParameterSpinBox->value());
+  }
+  if (Pipeline::parametersNumber(type) > 1) {
+    parameters.push_back(m_secondIntegerSpinBox->value());
+  }
+
+  try {
+    m_pipeline.addStage(type, parameters);
+  } catch (Pipeline::InvalidParameter) {
+    QMessageBox::information(this, tr("Error"),
+                             tr("Parameters must be positive"));
+    return;
+  }
+  updateStagesList();
+
+  m_stagesList->setCurrentRow(m_stagesList->count() - 1);
+}
+
+void PipelineWindow::onRemoveButtonPress() {
+  int row = m_stagesList->currentRow();
+  if (row < 0) return;
+
+  m_pipeline.removeStage(row);
+  updateStagesList();
+
+  m_stagesList->setCurrentRow(std::min(row, m_stagesList->count() - 1));
+}
+
+void PipelineWindow::onUpButtonPress() {
+  int row = m_stagesList->currentRow();
+  if (row <= 0) return;
+
+  m_pipeline.moveStage(row, row - 1);
+  updateStagesList();
+
+  m_stagesList->setCurrentRow(row - 1);
+}
+
+void PipelineWindow::onDownButtonPress() {
+  int row = m_stagesList->currentRow();
+  if (row < 0 || row + 1 >= m_stagesList->count()) return;
+
+  m_pipeline.moveStage(row, row + 1);
+  updateStagesList();
+
+  m_stagesList->setCurrentRow(row + 1);
+}
+
+void PipelineWindow::onLoadButtonPress() {
+  QString fileName = QFileDialog::getOpenFileName(
+      this, tr("Open pipeline"), QDir::homePath(),
+      tr("Pipeline files (*.pipeline)"));
+
+  if (fileName == "") return;
+
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return;
+
+  QTextStream in(&file);
+
+  try {
+    m_pipeline = Pipeline::fromString(in.readAll().toStdString());
+  } catch (Pipeline::ParseError) {
+    QMessageBox::information(this, tr("Error"),
+                             tr("File is not a valid pipeline."));
+  } catch (Pipeline::InvalidParameter) {
+    QMessageBox::information(this, tr("Error"),
+                             tr("Pipeline file has a parameter out of range."));
+  }
+
+  updateStagesList();
+}
+
+void PipelineWindow::onSaveButtonPress() {
+  QString fileName = QFileDialog::getSaveFileName(
+      this, tr("Save pipeline"), QDir::homePath(),
+      tr("Pipeline files (*.pipeline)"));
+
+  if (fileName == "") return;
+
+  if (!fileName.endsWith(".pipeline")) fileName += ".pipeline";
+
+  QFile out(fileName);
+  if (out.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    QTextStream stream(&out);
+    stream << QString::fromStdString(m_pipeline.toString());
+    out.close();
+  }
+}
+
+void PipelineWindow::updateStagesList() {
+  m_stagesList->clear();
+
+  for (const Pipeline::Stage &stage : m_pipeline.stages()) {
+    QStringList titles = parametersTitle(stage.type);
+
+    QString text = stageTitle(stage.type);
+    for (int i = 0; i < stage.parameters.size(); ++i) {
+      text += (i ? ", " : ": ") + titles[i] + " " +
+              QString::number(stage.parameters[i]);
+    }
+
+    m_stagesList->addItem(text);
+  }
+
+  m_rateLabel->setText(
+      tr("Output sampling frequency: ") +
+      QString::number(m_pipeline.outputRate(p_signalData->rate())) +
+      tr(" HZ"));
+}
+
+QString PipelineWindow::stageTitle(Pipeline::StageType type) const {
+  switch (type) {
+    case Pipeline::StageType::Detrend:
+      return tr("Detrend");
+    case Pipeline::StageType::Lowpass:
+      return tr("Lowpass filter");
+    case Pipeline::StageType::Highpass:
+      return tr("Highpass filter");
+    case Pipeline::StageType::Median:
+      return tr("Median filter");
+    case Pipeline::StageType::Resample:
+      return tr("Resample");
+    case Pipeline::StageType::Rectify:
+      return tr("Rectify");
+    case Pipeline::StageType::Envelope:
+      return tr("Envelope");
+    case Pipeline::StageType::Decimate:
+      return tr("Decimate");
+  }
+
+  return "";
+}
+
+QStringList PipelineWindow::parametersTitle(Pipeline::StageType type) const {
+  switch (type) {
+    case Pipeline::StageType::Detrend:
+    case Pipeline::StageType::Median:
+      return {tr("Window width:")};
+    case Pipeline::StageType::Lowpass:
+    case Pipeline::StageType::Highpass:
+    case Pipeline::StageType::Envelope:
+      return {tr("Cutoff frequency:")};
+    case Pipeline::StageType::Resample:
+      return {tr("Interpolation factor (L):"), tr("Decimation factor (M):")};
+    case Pipeline::StageType::Rectify:
+      return {};
+    case Pipeline::StageType::Decimate:
+      return {tr("Decimation factor (M):")};
+  }
+
+  return {};
+}
+
+}  // namespace fssp
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDialog>
+#include <QDoubleSpinBox>
+#include <QLabel>
+#include <QListWidget>
+#include <QSpinBox>
+#include <QWidget>
+
+#include "pipeline.h"
+#include "signaldata.h"
+
+namespace fssp {
+
+class PipelineWindow : public QDialog {
+  Q_OBJECT
+ public:
+  explicit PipelineWindow(std::shared_ptr<SignalData> signalData,
+                          const Pipeline &pipeline, QWidget *parent = nullptr);
+
+  const Pipeline &pipeline() const;
+  std::vector<int> channels() const;
+
+ protected slots:
+  void onStageTypeChange(int index);
+  void onAddButtonPress();
+  void onRemoveButtonPress();
+  void onUpButtonPress();
+  void onDownButtonPress();
+  void onLoadButtonPress();
+  void onSaveButtonPress();
+
+ private:
+  void updateStagesList();
+
+  QString stageTitle(Pipeline::StageType type) const;
+  QStringList parametersTitle(Pipeline::StageType type) const;
+
+  std::shared_ptr<SignalData> p_signalData;
+
+  Pipeline m_pipeline;
+
+  QListWidget *m_stagesList;
+
+  QComboBox *m_stageComboBox;
+
+  // Вещественный параметр (частота среза) и целые (окна, множители).
+  QLabel *m_firstParameterLabel;
+  QDoubleSpinBox *m_firstParameterSpinBox;
+  QSpinBox *m_firstIntegerSpinBox;
+  QLabel *m_secondParameterLabel;
+  QSpinBox *m_secondIntegerSpinBox;
+
+  QLabel *m_rateLabel;
+
+  std::vector<QCheckBox *> m_checkBoxes;
+};
+
+}  // namespace fssp
@@ -0,0 +1,116 @@
+#include "quantileindex.h"
+
+#include <algorithm>
+
+#include "parallel.h"
+#include "quantiles.h"
+
+namespace fssp {
+
+std::atomic<double> QuantileIndex::s_defaultCompression{200};
+
+QuantileIndex::QuantileIndex(const ChannelSource &channel, double compression)
+    : m_compression{compression} {
+  size_t size = channel.size();
+  size_t blocksNumber = (size + blockSize - 1) / blockSize;
+
+  m_blocks = std::vector<TDigest>(blocksNumber, TDigest(m_compression));
+  auto addBlock = [&](size_t i) {
+    size_t start = i * blockSize;
+    size_t count = std::min(blockSize, size - start);
+
+    if (const double *samples = channel.samples()) {
+      m_blocks[i].add(samples + start, count);
+      return;
+    }
+
+    std::vector<double> block = read(channel, start, count);
+    m_blocks[i].add(block.data(), count);
+  };
+
+  // Индекс строится впрок и уступает потоки отрисовке.
+  parallelFor(0, blocksNumber, addBlock, Scheduler::Background);
+
+  // Группы только целых блоков, неполная последняя группа не нужна.
+  size_t groupsNumber = blocksNumber / groupSize;
+
+  m_groups = std::vector<TDigest>(groupsNumber, TDigest(m_compression));
+  auto mergeGroup = [&](size_t i) {
+    for (size_t j = i * groupSize; j < (i + 1) * groupSize; ++j) {
+      m_groups[i].merge(m_blocks[j]);
+    }
+  };
+  parallelFor(0, groupsNumber, mergeGroup, Scheduler::Background);
+}
+
+double QuantileIndex::defaultCompression() {
+  return s_defaultCompression;
+}
+
+void QuantileIndex::setDefaultCompression(double compression) {
+  s_defaultCompression = compression;
+}
+
+double QuantileIndex::compression() const { return m_compression; }
+
+std::vector<double> QuantileIndex::read(const ChannelSource &channel,
+                                        size_t start, size_t count) {
+  std::vector<double> data(count);
+  if (count) channel.read(start, count, data.data());
+
+  return data;
+}
+
+std::vector<double> QuantileIndex::exactQuantiles(
+    const ChannelSource &channel, size_t start, size_t count,
+    const std::vector<double> &orders) {
+  std::vector<double> data = read(channel, start, count);
+  return fssp::quantiles(data, orders);
+}
+
+std::vector<double> QuantileIndex::quantiles(
+    const ChannelSource &channel, size_t start, size_t count,
+    const std::vector<double> &orders) const {
+  if (count <= exactLimit) {
+    return exactQuantiles(channel, start, count, orders);
+  }
+
+  size_t end = start + count;
+
+  size_t first = (start + blockSize - 1) / blockSize;
+  size_t last = end / blockSize;
+
+  TDigest digest(m_compression);
+
+  // Целые группы, затем оставшиеся целые блоки.
+  size_t firstGroup = (first + groupSize - 1) / groupSize;
+  size_t lastGroup = last / groupSize;
+  if (firstGroup < lastGroup) {
+    for (size_t i = firstGroup; i < lastGroup; ++i) digest.merge(m_groups[i]);
+    for (size_t i = first; i < firstGroup * groupSize; ++i) {
+      digest.merge(m_blocks[i]);
+    }
+    for (size_t i = lastGroup * groupSize; i < last; ++i) {
+      digest.merge(m_blocks[i]);
+    }
+  } else {
+    for (size_t i = first; i < last; ++i) digest.merge(m_blocks[i]);
+  }
+
+  // Неполные блоки на краях.
+  size_t left = std::min(end, first * blockSize);
+  std::vector<double> edge = read(channel, start, left - start);
+  digest.add(edge.data(), edge.size());
+
+  if (last >= first) {
+    edge = read(channel, last * blockSize, end - last * blockSize);
+    digest.add(edge.data(), edge.size());
+  }
+
+  std::vector<double> result;
+  for (double order : orders) result.push_back(digest.quantile(order));
+
+  return result;
+}
+
+}  // namespace fssp
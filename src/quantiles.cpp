@@ -0,0 +1,53 @@
+#include "quantiles.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace fssp {
+
+namespace {
+
+// Ставит на места ranks[first, last) их порядковые статистики. Все эти
+// места лежат в [begin, end), элементы левее begin не больше, а правее
+// end не меньше элементов диапазона.
+void select(std::vector<double> &data, size_t begin, size_t end,
+            const std::vector<size_t> &ranks, size_t first, size_t last) {
+  if (first >= last) return;
+
+  size_t middle = first + (last - first) / 2;
+  size_t rank = ranks[middle];
+
+  std::nth_element(data.begin() + begin, data.begin() + rank,
+                   data.begin() + end);
+
+  select(data, begin, rank, ranks, first, middle);
+  select(data, rank + 1, end, ranks, middle + 1, last);
+}
+
+}  // namespace
+
+std::vector<double> quantiles(std::vector<double> &data,
+                              const std::vector<double> &orders) {
+  std::vector<double> result(orders.size());
+  if (data.empty()) return result;
+
+  size_t n = data.size();
+
+  std::vector<size_t> ranks(orders.size());
+  for (size_t i = 0; i < orders.size(); ++i) {
+    double rank = std::floor(n * std::clamp(orders[i], 0., 1.));
+    ranks[i] = std::min(n - 1, static_cast<size_t>(rank));
+  }
+
+  std::vector<size_t> sorted = ranks;
+  std::sort(sorted.begin(), sorted.end());
+  sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+  select(data, 0, n, sorted, 0, sorted.size());
+
+  for (size_t i = 0; i < ranks.size(); ++i) result[i] = data[ranks[i]];
+
+  return result;
+}
+
+}  // namespace fssp
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace fssp {
+
+// Квантили порядков orders (от 0 до 1): элементы с номерами
+// min(n - 1, floor(n * order)) упорядоченного data. Вместо сортировки
+// нужные порядковые статистики выбираются nth_element, для нескольких
+// порядков делением диапазона пополам, поэтому время почти линейное.
+// Порядок элементов data изменяется.
+std::vector<double> quantiles(std::vector<double> &data,
+                              const std::vector<double> &orders);
+
+}  // namespace fssp
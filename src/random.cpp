@@ -0,0 +1,130 @@
+#include "random.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace fssp {
+
+namespace {
+
+uint64_t splitMix(uint64_t &x) {
+  uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+// Зиккурат из 256 слоев одинаковой площади (Marsaglia, Tsang; Doornik).
+struct Ziggurat {
+  static constexpr int layers = 256;
+  static constexpr double tail = 3.6541528853610088;
+  static constexpr double area = 0.00492867323399;
+
+  Ziggurat() {
+    double f = std::exp(-0.5 * tail * tail);
+
+    x[0] = area / f;
+    x[1] = tail;
+    for (int i = 2; i < layers; ++i) {
+      x[i] = std::sqrt(-2 * std::log(area / x[i - 1] + f));
+      f = std::exp(-0.5 * x[i] * x[i]);
+    }
+    x[layers] = 0;
+
+    for (int i = 0; i < layers; ++i) ratio[i] = x[i + 1] / x[i];
+  }
+
+  double x[layers + 1];
+  double ratio[layers];
+};
+
+const Ziggurat &ziggurat() {
+  static const Ziggurat instance;
+  return instance;
+}
+
+}  // namespace
+
+Random::Random(uint64_t seed, uint64_t stream) {
+  uint64_t x = seed;
+  x = splitMix(x) ^ (stream * 0xD1B54A32D192ED03ull);
+  for (uint64_t &state : m_state) state = splitMix(x);
+}
+
+uint64_t Random::next() {
+  uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+  uint64_t t = m_state[1] << 17;
+
+  m_state[2] ^= m_state[0];
+  m_state[3] ^= m_state[1];
+  m_state[1] ^= m_state[2];
+  m_state[0] ^= m_state[3];
+  m_state[2] ^= t;
+  m_state[3] = rotl(m_state[3], 45);
+
+  return result;
+}
+
+double Random::uniform() { return (next() >> 11) * 0x1.0p-53; }
+
+double Random::normal() {
+  const Ziggurat &table = ziggurat();
+
+  for (;;) {
+    uint64_t bits = next();
+
+    int layer = bits & 0xFF;
+    double u = 2 * ((bits >> 11) * 0x1.0p-53) - 1;
+
+    if (std::fabs(u) < table.ratio[layer]) return u * table.x[layer];
+
+    if (layer == 0) {
+      double x, y;
+      do {
+        x = std::log(1 - uniform()) / Ziggurat::tail;
+        y = std::log(1 - uniform());
+      } while (-2 * y < x * x);
+      return u < 0 ? x - Ziggurat::tail : Ziggurat::tail - x;
+    }
+
+    double x = u * table.x[layer];
+    double f0 = std::exp(-0.5 * (table.x[layer] * table.x[layer] - x * x));
+    double f1 =
+        std::exp(-0.5 * (table.x[layer + 1] * table.x[layer + 1] - x * x));
+    if (f1 + uniform() * (f0 - f1) < 1) return x;
+  }
+}
+
+template <typename Sample>
+void Random::fill(double *output, uint64_t seed, size_t start, size_t count,
+                  Sample sample) {
+  size_t end = start + count;
+
+  for (size_t block = start / blockSize; block * blockSize < end; ++block) {
+    Random random(seed, block);
+
+    size_t first = std::max(start, block * blockSize);
+    size_t last = std::min(end, (block + 1) * blockSize);
+
+    // Начало блока пропускается, чтобы отсчеты не зависели от разбиения.
+    for (size_t i = block * blockSize; i < first; ++i) sample(random);
+    for (size_t i = first; i < last; ++i) output[i - start] = sample(random);
+  }
+}
+
+void Random::fillUniform(double *output, uint64_t seed, size_t start,
+                         size_t count, double min, double max) {
+  fill(output, seed, start, count,
+       [&](Random &random) { return min + (max - min) * random.uniform(); });
+}
+
+void Random::fillNormal(double *output, uint64_t seed, size_t start,
+                        size_t count, double mean, double deviation) {
+  fill(output, seed, start, count, [&](Random &random) {
+    return mean + deviation * random.normal();
+  });
+}
+
+}  // namespace fssp
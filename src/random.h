@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fssp {
+
+// Генератор xoshiro256** с независимыми потоками для одного зерна и
+// нормальным распределением по методу зиккурата.
+class Random {
+ public:
+  // Длина блока шумовой последовательности, у каждого блока свой поток.
+  static constexpr size_t blockSize = 1 << 16;
+
+  explicit Random(uint64_t seed, uint64_t stream = 0);
+
+  uint64_t next();
+
+  // Равномерное распределение на [0, 1).
+  double uniform();
+
+  // Стандартное нормальное распределение.
+  double normal();
+
+  // Отсчеты [start, start + count) шумовой последовательности с зерном
+  // seed. Результат не зависит от того, какими частями и в каком порядке
+  // запрашивается последовательность, поэтому ее можно заполнять
+  // параллельно.
+  static void fillUniform(double *output, uint64_t seed, size_t start,
+                          size_t count, double min, double max);
+  static void fillNormal(double *output, uint64_t seed, size_t start,
+                         size_t count, double mean, double deviation);
+
+ private:
+  template <typename Sample>
+  static void fill(double *output, uint64_t seed, size_t start, size_t count,
+                   Sample sample);
+
+  uint64_t m_state[4];
+};
+
+}  // namespace fssp
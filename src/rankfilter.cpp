@@ -0,0 +1,164 @@
+#include "rankfilter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace fssp {
+
+RankFilter::RankFilter(RankFilter::Type type, int windowSize,
+                       double percentile) {
+  if (windowSize <= 0) throw RankFilter::InvalidWindow();
+
+  m_type = type;
+  m_windowSize = windowSize;
+  m_percentile = std::clamp(percentile, 0., 100.);
+
+  reset();
+}
+
+void RankFilter::reset() {
+  // Кольцевой буфер нужен только для удаления отсчетов из деревьев.
+  if (m_type == RankFilter::Type::Median ||
+      m_type == RankFilter::Type::Percentile) {
+    m_window.assign(m_windowSize, 0);
+  } else {
+    std::vector<double>().swap(m_window);
+  }
+  m_pushed = 0;
+
+  m_low.clear();
+  m_high.clear();
+  m_extremes.clear();
+
+  m_last = 0;
+}
+
+void RankFilter::process(const double *input, size_t count,
+                         std::vector<double> &output) {
+  size_t windowSize = m_windowSize;
+  int left = (m_windowSize - 1) / 2;
+
+  for (size_t i = 0; i < count; ++i) {
+    if (!m_pushed) {
+      for (int k = 0; k < left; ++k) push(input[i]);
+    }
+
+    push(input[i]);
+    if (m_pushed >= windowSize) output.push_back(value());
+  }
+
+  if (count) m_last = input[count - 1];
+}
+
+void RankFilter::flush(std::vector<double> &output) {
+  if (!m_pushed) return;
+
+  size_t windowSize = m_windowSize;
+  int right = m_windowSize - 1 - (m_windowSize - 1) / 2;
+
+  for (int k = 0; k < right; ++k) {
+    push(m_last);
+    if (m_pushed >= windowSize) output.push_back(value());
+  }
+}
+
+void RankFilter::push(double value) {
+  size_t windowSize = m_windowSize;
+  size_t index = m_pushed++;
+
+  if (m_type == RankFilter::Type::Minimum) {
+    if (!std::isnan(value)) {
+      while (!m_extremes.empty() && m_extremes.back().second >= value) {
+        m_extremes.pop_back();
+      }
+      m_extremes.push_back({index, value});
+    }
+    while (!m_extremes.empty() &&
+           m_extremes.front().first + windowSize <= index) {
+      m_extremes.pop_front();
+    }
+    return;
+  }
+
+  if (m_type == RankFilter::Type::Maximum) {
+    if (!std::isnan(value)) {
+      while (!m_extremes.empty() && m_extremes.back().second <= value) {
+        m_extremes.pop_back();
+      }
+      m_extremes.push_back({index, value});
+    }
+    while (!m_extremes.empty() &&
+           m_extremes.front().first + windowSize <= index) {
+      m_extremes.pop_front();
+    }
+    return;
+  }
+
+  // Выбывающий из окна отсчет.
+  double &slot = m_window[index % windowSize];
+  if (index >= windowSize && !std::isnan(slot)) {
+    if (!m_low.empty() && slot <= *m_low.rbegin()) {
+      m_low.erase(m_low.find(slot));
+    } else {
+      m_high.erase(m_high.find(slot));
+    }
+  }
+  slot = value;
+
+  if (!std::isnan(value)) {
+    if (!m_low.empty() && value <= *m_low.rbegin()) {
+      m_low.insert(value);
+    } else {
+      m_high.insert(value);
+    }
+  }
+
+  // В m_low должно лежать ровно rank + 1 наименьших отсчетов.
+  size_t count = m_low.size() + m_high.size();
+  size_t target = count ? rank(count) + 1 : 0;
+
+  while (m_low.size() > target) {
+    auto last = std::prev(m_low.end());
+    m_high.insert(*last);
+    m_low.erase(last);
+  }
+
+  while (m_low.size() < target) {
+    auto first = m_high.begin();
+    m_low.insert(*first);
+    m_high.erase(first);
+  }
+}
+
+double RankFilter::value() const {
+  if (m_type == RankFilter::Type::Minimum ||
+      m_type == RankFilter::Type::Maximum) {
+    return m_extremes.empty() ? NAN : m_extremes.front().second;
+  }
+
+  return m_low.empty() ? NAN : *m_low.rbegin();
+}
+
+size_t RankFilter::rank(size_t count) const {
+  if (m_type == RankFilter::Type::Percentile) {
+    return std::lround(m_percentile / 100. * (count - 1));
+  }
+
+  return (count - 1) / 2;
+}
+
+std::vector<double> RankFilter::filter(const std::vector<double> &data,
+                                       RankFilter::Type type, int windowSize,
+                                       double percentile) {
+  RankFilter rankFilter(type, windowSize, percentile);
+
+  std::vector<double> result;
+  result.reserve(data.size());
+
+  rankFilter.process(data.data(), data.size(), result);
+  rankFilter.flush(result);
+
+  return result;
+}
+
+}  // namespace fssp
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <set>
+#include <vector>
+
+namespace fssp {
+
+// Скользящий ранговый фильтр с центрированным окном. Медиана и процентили
+// считаются на двух сбалансированных деревьях (O(log w) на отсчет), минимум
+// и максимум - на монотонной очереди. Края дополняются крайними отсчетами.
+// Отсчеты NaN пропускаются: ранг берется среди остальных отсчетов окна, а
+// если в окне нет ни одного числа, результатом будет NaN.
+class RankFilter {
+ public:
+  enum class Type {
+    Median,
+    Percentile,
+    Minimum,
+    Maximum,
+  };
+
+  explicit RankFilter(RankFilter::Type type, int windowSize,
+                      double percentile = 50.);
+
+  void process(const double *input, size_t count, std::vector<double> &output);
+  void flush(std::vector<double> &output);
+
+  void reset();
+
+  static std::vector<double> filter(const std::vector<double> &data,
+                                    RankFilter::Type type, int windowSize,
+                                    double percentile = 50.);
+
+  class InvalidWindow : public std::exception {
+   public:
+    virtual const char *what() const throw() {
+      return "Window size must be positive";
+    }
+  };
+
+ private:
+  void push(double value);
+  double value() const;
+  size_t rank(size_t count) const;
+
+  RankFilter::Type m_type;
+
+  int m_windowSize;
+  double m_percentile;
+
+  std::vector<double> m_window;
+  size_t m_pushed;
+
+  std::multiset<double> m_low;
+  std::multiset<double> m_high;
+
+  std::deque<std::pair<size_t, double>> m_extremes;
+
+  double m_last;
+};
+
+}  // namespace fssp
@@ -0,0 +1,202 @@
+#include "resampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace fssp {
+
+namespace {
+
+double besselI0(double x) {
+  double sum = 1;
+  double term = 1;
+  for (int k = 1; k < 50; ++k) {
+    term *= (x / (2 * k)) * (x / (2 * k));
+    sum += term;
+    if (term < sum * 1e-16) break;
+  }
+  return sum;
+}
+
+}  // namespace
+
+Resampler::Resampler(int upFactor, int downFactor, int zeroCrossings) {
+  if (upFactor <= 0 || downFactor <= 0 || zeroCrossings <= 0) {
+    throw Resampler::InvalidRatio();
+  }
+
+  int divisor = std::gcd(upFactor, downFactor);
+
+  m_upFactor = upFactor / divisor;
+  m_downFactor = downFactor / divisor;
+  m_zeroCrossings = zeroCrossings;
+
+  designFilter();
+  reset();
+}
+
+int Resampler::upFactor() const { return m_upFactor; }
+
+int Resampler::downFactor() const { return m_downFactor; }
+
+double Resampler::ratio() const {
+  return static_cast<double>(m_upFactor) / static_cast<double>(m_downFactor);
+}
+
+size_t Resampler::outputSize(size_t inputSize) const {
+  return (inputSize * m_upFactor + m_downFactor - 1) / m_downFactor;
+}
+
+void Resampler::designFilter() {
+  int factor = std::max(m_upFactor, m_downFactor);
+
+  // Нечетная длина, чтобы задержка фильтра была целой.
+  int length = 2 * m_zeroCrossings * factor + 1;
+  m_tapsPerPhase = (length + m_upFactor - 1) / m_upFactor;
+  m_delay = (length - 1) / 2;
+
+  double cutoff = 0.45 / factor;
+  double beta = 7.857;
+  double norm = besselI0(beta);
+
+  std::vector<double> taps(m_tapsPerPhase * m_upFactor, 0.);
+  for (int k = 0; k < length; ++k) {
+    double x = k - static_cast<double>(m_delay);
+
+    double sinc = 2 * cutoff;
+    if (x != 0) {
+      sinc = std::sin(2 * M_PI * cutoff * x) / (M_PI * x);
+    }
+
+    double r = x / m_delay;
+    double window = besselI0(beta * std::sqrt(std::max(0., 1 - r * r))) / norm;
+
+    taps[k] = m_upFactor * sinc * window;
+  }
+
+  m_phases = std::vector<double>(m_tapsPerPhase * m_upFactor);
+  for (int phase = 0; phase < m_upFactor; ++phase) {
+    for (int j = 0; j < m_tapsPerPhase; ++j) {
+      m_phases[phase * m_tapsPerPhase + (m_tapsPerPhase - 1 - j)] =
+          taps[phase + j * m_upFactor];
+    }
+  }
+}
+
+void Resampler::reset() {
+  m_buffer = std::vector<double>(m_tapsPerPhase - 1, 0.);
+
+  m_time = static_cast<size_t>(m_tapsPerPhase - 1) * m_upFactor + m_delay;
+
+  m_inputCount = 0;
+  m_outputCount = 0;
+}
+
+void Resampler::process(const double *input, size_t count,
+                        std::vector<double> &output) {
+  m_inputCount += count;
+
+  if (m_upFactor == 1 && m_downFactor == 1) {
+    output.insert(output.end(), input, input + count);
+    m_outputCount += count;
+    return;
+  }
+
+  m_buffer.insert(m_buffer.end(), input, input + count);
+
+  size_t total = m_buffer.size();
+  size_t history = m_tapsPerPhase - 1;
+
+  while (m_time / m_upFactor < total) {
+    size_t n = m_time / m_upFactor;
+    size_t phase = m_time % m_upFactor;
+
+    const double *taps = m_phases.data() + phase * m_tapsPerPhase;
+    const double *samples = m_buffer.data() + (n - history);
+
+    double sum = 0;
+    for (int j = 0; j < m_tapsPerPhase; ++j) {
+      sum += taps[j] * samples[j];
+    }
+
+    output.push_back(sum);
+    ++m_outputCount;
+
+    m_time += m_downFactor;
+  }
+
+  if (total > history) {
+    size_t drop = total - history;
+    m_buffer.erase(m_buffer.begin(), m_buffer.begin() + drop);
+    m_time -= drop * m_upFactor;
+  }
+}
+
+void Resampler::flush(std::vector<double> &output) {
+  size_t expected = outputSize(m_inputCount);
+  size_t inputCount = m_inputCount;
+
+  std::vector<double> zeros(m_tapsPerPhase, 0.);
+  while (m_outputCount < expected) {
+    process(zeros.data(), zeros.size(), output);
+  }
+
+  if (m_outputCount > expected) {
+    output.resize(output.size() - (m_outputCount - expected));
+    m_outputCount = expected;
+  }
+
+  m_inputCount = inputCount;
+}
+
+std::vector<double> Resampler::resample(const std::vector<double> &data,
+                                        int upFactor, int downFactor) {
+  Resampler resampler(upFactor, downFactor);
+
+  std::vector<double> result;
+  result.reserve(resampler.outputSize(data.size()));
+
+  resampler.process(data.data(), data.size(), result);
+  resampler.flush(result);
+
+  return result;
+}
+
+void Resampler::approximateRatio(double ratio, int &upFactor, int &downFactor,
+                                 int maxFactor) {
+  if (!std::isfinite(ratio) || ratio <= 0 || maxFactor <= 0) {
+    throw Resampler::InvalidRatio();
+  }
+
+  // Иначе первый же член цепной дроби больше maxFactor.
+  if (ratio > maxFactor || ratio < 1. / maxFactor) {
+    throw Resampler::UnsupportedRatio();
+  }
+
+  long long h0 = 0, h1 = 1;
+  long long k0 = 1, k1 = 0;
+
+  double x = ratio;
+  for (int i = 0; i < 64; ++i) {
+    double a = std::floor(x);
+
+    long long h2 = static_cast<long long>(a) * h1 + h0;
+    long long k2 = static_cast<long long>(a) * k1 + k0;
+    if (h2 > maxFactor || k2 > maxFactor) break;
+
+    h0 = h1;
+    h1 = h2;
+    k0 = k1;
+    k1 = k2;
+
+    double frac = x - a;
+    if (frac < 1e-12) break;
+    x = 1 / frac;
+  }
+
+  upFactor = h1;
+  downFactor = k1;
+}
+
+}  // namespace fssp
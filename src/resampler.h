@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <vector>
+
+namespace fssp {
+
+// Передискретизация в рациональное число раз L/M полифазным фильтром
+// (окно Кайзера). Данные можно подавать блоками, задержка фильтра
+// компенсируется, выход выровнен по входу.
+class Resampler {
+ public:
+  explicit Resampler(int upFactor, int downFactor, int zeroCrossings = 16);
+
+  int upFactor() const;
+  int downFactor() const;
+
+  double ratio() const;
+
+  size_t outputSize(size_t inputSize) const;
+
+  void process(const double *input, size_t count, std::vector<double> &output);
+  void flush(std::vector<double> &output);
+
+  void reset();
+
+  static std::vector<double> resample(const std::vector<double> &data,
+                                     int upFactor, int downFactor);
+
+  // Лучшее приближение ratio дробью upFactor / downFactor с множителями не
+  // больше maxFactor. Отношения вне [1 / maxFactor, maxFactor] так не
+  // приблизить, для них бросается UnsupportedRatio.
+  static void approximateRatio(double ratio, int &upFactor, int &downFactor,
+                               int maxFactor = 1000);
+
+  class InvalidRatio : public std::exception {
+   public:
+    virtual const char *what() const throw() {
+      return "Resampling factors must be positive";
+    }
+  };
+
+  class UnsupportedRatio : public std::exception {
+   public:
+    virtual const char *what() const throw() {
+      return "Resampling ratio is out of the supported range";
+    }
+  };
+
+ private:
+  void designFilter();
+
+  int m_upFactor;
+  int m_downFactor;
+  int m_zeroCrossings;
+  int m_tapsPerPhase;
+
+  // m_upFactor фаз по m_tapsPerPhase коэффициентов в обратном порядке.
+  std::vector<double> m_phases;
+
+  std::vector<double> m_buffer;
+
+  size_t m_time;
+  size_t m_delay;
+
+  size_t m_inputCount;
+  size_t m_outputCount;
+};
+
+}  // namespace fssp
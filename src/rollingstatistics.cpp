@@ -0,0 +1,178 @@
+#include "rollingstatistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+
+namespace fssp {
+
+RollingStatistics::RollingStatistics(int windowSize, int hop) {
+  if (windowSize <= 0 || hop <= 0) throw RollingStatistics::InvalidWindow();
+
+  m_windowSize = windowSize;
+  m_hop = hop;
+}
+
+size_t RollingStatistics::outputSize(size_t inputSize) const {
+  return (inputSize + m_hop - 1) / m_hop;
+}
+
+std::vector<std::vector<double>> RollingStatistics::compute(
+    const std::vector<double> &data,
+    const std::vector<RollingStatistics::Type> &types) const {
+  size_t size = data.size();
+  size_t left = (m_windowSize - 1) / 2;
+  size_t right = m_windowSize - 1 - left;
+
+  bool needSums = false;
+  bool needMinimum = false;
+  bool needMaximum = false;
+  for (RollingStatistics::Type type : types) {
+    switch (type) {
+      case RollingStatistics::Type::Mean:
+      case RollingStatistics::Type::Rms:
+      case RollingStatistics::Type::StandardDeviation: {
+        needSums = true;
+        break;
+      }
+      case RollingStatistics::Type::Minimum: {
+        needMinimum = true;
+        break;
+      }
+      case RollingStatistics::Type::Maximum: {
+        needMaximum = true;
+        break;
+      }
+      case RollingStatistics::Type::PeakToPeak: {
+        needMinimum = true;
+        needMaximum = true;
+        break;
+      }
+    }
+  }
+
+  std::vector<std::vector<double>> result(types.size());
+  for (std::vector<double> &output : result) output.reserve(outputSize(size));
+
+  // Суммы отклонений от первого отсчета, чтобы не терять точность на
+  // сигналах с большой постоянной составляющей.
+  double shift = size ? data[0] : 0;
+  double sum = 0;
+  double squaresSum = 0;
+
+  // Вычитание выбывающих отсчетов накапливает ошибку округления, поэтому
+  // после каждых m_windowSize удалений суммы пересчитываются заново.
+  size_t removed = 0;
+
+  std::deque<size_t> minimums;
+  std::deque<size_t> maximums;
+
+  // Окно [begin, end).
+  size_t begin = 0;
+  size_t end = 0;
+
+  for (size_t center = 0; center < size; center += m_hop) {
+    size_t newBegin = center > left ? center - left : 0;
+    size_t newEnd = std::min(size, center + right + 1);
+
+    // Шаг больше окна: старое окно выбывает целиком.
+    if (newBegin >= end) {
+      begin = end = newBegin;
+      sum = squaresSum = 0;
+      minimums.clear();
+      maximums.clear();
+    }
+
+    for (; end < newEnd; ++end) {
+      double value = data[end];
+
+      if (needSums) {
+        double deviation = value - shift;
+        sum += deviation;
+        squaresSum += deviation * deviation;
+      }
+
+      if (needMinimum) {
+        while (!minimums.empty() && data[minimums.back()] >= value) {
+          minimums.pop_back();
+        }
+        minimums.push_back(end);
+      }
+
+      if (needMaximum) {
+        while (!maximums.empty() && data[maximums.back()] <= value) {
+          maximums.pop_back();
+        }
+        maximums.push_back(end);
+      }
+    }
+
+    if (needSums) {
+      for (; begin < newBegin; ++begin, ++removed) {
+        double deviation = data[begin] - shift;
+        sum -= deviation;
+        squaresSum -= deviation * deviation;
+      }
+
+      if (removed >= static_cast<size_t>(m_windowSize)) {
+        sum = squaresSum = 0;
+        for (size_t i = begin; i < end; ++i) {
+          double deviation = data[i] - shift;
+          sum += deviation;
+          squaresSum += deviation * deviation;
+        }
+        removed = 0;
+      }
+    }
+    begin = newBegin;
+
+    while (!minimums.empty() && minimums.front() < begin) {
+      minimums.pop_front();
+    }
+    while (!maximums.empty() && maximums.front() < begin) {
+      maximums.pop_front();
+    }
+
+    double count = end - begin;
+    double mean = sum / count;
+    double meanSquare = squaresSum / count;
+
+    for (size_t i = 0; i < types.size(); ++i) {
+      double value = 0;
+
+      switch (types[i]) {
+        case RollingStatistics::Type::Mean: {
+          value = shift + mean;
+          break;
+        }
+        case RollingStatistics::Type::Rms: {
+          value = std::sqrt(std::max(
+              0., meanSquare + 2 * shift * mean + shift * shift));
+          break;
+        }
+        case RollingStatistics::Type::StandardDeviation: {
+          value = std::sqrt(std::max(0., meanSquare - mean * mean));
+          break;
+        }
+        case RollingStatistics::Type::Minimum: {
+          value = data[minimums.front()];
+          break;
+        }
+        case RollingStatistics::Type::Maximum: {
+          value = data[maximums.front()];
+          break;
+        }
+        case RollingStatistics::Type::PeakToPeak: {
+          value = data[maximums.front()] - data[minimums.front()];
+          break;
+        }
+      }
+
+      result[i].push_back(value);
+    }
+  }
+
+  return result;
+}
+
+}  // namespace fssp
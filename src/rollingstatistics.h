@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <vector>
+
+namespace fssp {
+
+// Статистики в скользящем центрированном окне. На краях окно усекается до
+// имеющихся отсчетов. Среднее, СКЗ и СКО считаются по бегущим суммам,
+// минимум и максимум - на монотонных очередях, так что на отсчет
+// приходится O(1) операций независимо от ширины окна. С шагом hop
+// выводится каждое hop-е окно.
+class RollingStatistics {
+ public:
+  enum class Type {
+    Mean,
+    Rms,
+    StandardDeviation,
+    Minimum,
+    Maximum,
+    PeakToPeak,
+  };
+
+  explicit RollingStatistics(int windowSize, int hop = 1);
+
+  size_t outputSize(size_t inputSize) const;
+
+  // Результаты для всех types за один проход по data, в порядке types.
+  std::vector<std::vector<double>> compute(
+      const std::vector<double> &data,
+      const std::vector<RollingStatistics::Type> &types) const;
+
+  class InvalidWindow : public std::exception {
+   public:
+    virtual const char *what() const throw() {
+      return "Window size and hop must be positive";
+    }
+  };
+
+ private:
+  int m_windowSize;
+  int m_hop;
+};
+
+}  // namespace fssp
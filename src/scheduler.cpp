@@ -0,0 +1,183 @@
+#include "scheduler.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace fssp {
+
+thread_local int Scheduler::t_workerIndex = -1;
+
+// Общее состояние parallelFor. Задачи-помощники держат его через
+// shared_ptr, так что опоздавшие могут запуститься уже после возврата
+// из parallelFor: итераций они не получат и к function не обратятся.
+struct Scheduler::Loop {
+  std::atomic<size_t> next;
+  size_t end;
+
+  std::atomic<size_t> remaining;
+
+  const std::function<void(size_t)> *function;
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::exception_ptr exception;
+};
+
+Scheduler &Scheduler::instance() {
+  static Scheduler scheduler;
+  return scheduler;
+}
+
+Scheduler::Scheduler() : m_workers(maxThreadsNumber) {
+  setThreadsNumber(std::thread::hardware_concurrency());
+}
+
+Scheduler::~Scheduler() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_condition.notify_all();
+
+  for (std::thread &thread : m_threads) thread.join();
+}
+
+size_t Scheduler::threadsNumber() const { return m_threadsNumber; }
+
+void Scheduler::setThreadsNumber(size_t threadsNumber) {
+  threadsNumber = std::clamp<size_t>(threadsNumber, 1, maxThreadsNumber);
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_threadsNumber = threadsNumber;
+    for (size_t i = m_threads.size(); i < threadsNumber; ++i) {
+      m_threads.emplace_back(&Scheduler::run, this, i);
+    }
+    m_startedNumber = m_threads.size();
+  }
+  m_condition.notify_all();
+}
+
+void Scheduler::submit(Task task, Priority priority) {
+  // Задачи из рабочего потока остаются в его очереди, остальные
+  // распределяются по очереди.
+  size_t threadsNumber = m_threadsNumber;
+  size_t index = t_workerIndex >= 0 &&
+                         static_cast<size_t>(t_workerIndex) < threadsNumber
+                     ? t_workerIndex
+                     : m_nextWorker++ % threadsNumber;
+
+  {
+    std::lock_guard<std::mutex> lock(m_workers[index].mutex);
+    m_workers[index].tasks[priority].push_back(std::move(task));
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_pending;
+  }
+  m_condition.notify_one();
+}
+
+bool Scheduler::pop(size_t index, Task &task) {
+  // Крадем и у уснувших потоков, чтобы их задачи не остались в очереди.
+  size_t workersNumber = m_startedNumber;
+
+  for (int priority : {Interactive, Background}) {
+    {
+      Worker &own = m_workers[index];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (!own.tasks[priority].empty()) {
+        task = std::move(own.tasks[priority].back());
+        own.tasks[priority].pop_back();
+        return true;
+      }
+    }
+
+    for (size_t i = 1; i < workersNumber; ++i) {
+      Worker &victim = m_workers[(index + i) % workersNumber];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks[priority].empty()) {
+        task = std::move(victim.tasks[priority].front());
+        victim.tasks[priority].pop_front();
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+void Scheduler::run(size_t index) {
+  t_workerIndex = index;
+
+  while (true) {
+    Task task;
+    if (index < m_threadsNumber && pop(index, task)) {
+      --m_pending;
+      task();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // Перед остановкой очереди выполняются до конца.
+    if (m_stopping && (!m_pending || index >= m_threadsNumber)) break;
+
+    m_condition.wait(lock, [&]() {
+      return m_stopping || (m_pending && index < m_threadsNumber);
+    });
+  }
+
+  t_workerIndex = -1;
+}
+
+void Scheduler::runLoop(const std::shared_ptr<Loop> &loop) {
+  for (size_t i = loop->next++; i < loop->end; i = loop->next++) {
+    try {
+      (*loop->function)(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(loop->mutex);
+      if (!loop->exception) loop->exception = std::current_exception();
+    }
+
+    if (--loop->remaining == 0) {
+      std::lock_guard<std::mutex> lock(loop->mutex);
+      loop->condition.notify_all();
+    }
+  }
+}
+
+void Scheduler::parallelFor(size_t begin, size_t end,
+                            const std::function<void(size_t)> &function,
+                            Priority priority) {
+  if (begin >= end) return;
+
+  size_t helpersNumber = std::min<size_t>(m_threadsNumber, end - begin) - 1;
+
+  if (!helpersNumber) {
+    for (size_t i = begin; i < end; ++i) function(i);
+    return;
+  }
+
+  std::shared_ptr<Loop> loop = std::make_shared<Loop>();
+  loop->next = begin;
+  loop->end = end;
+  loop->remaining = end - begin;
+  loop->function = &function;
+
+  for (size_t i = 0; i < helpersNumber; ++i) {
+    submit([loop]() { runLoop(loop); }, priority);
+  }
+
+  runLoop(loop);
+
+  // Ждем только итерации, уже взятые другими потоками.
+  std::unique_lock<std::mutex> lock(loop->mutex);
+  loop->condition.wait(lock, [&]() { return loop->remaining == 0; });
+
+  if (loop->exception) std::rethrow_exception(loop->exception);
+}
+
+}  // namespace fssp
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fssp {
+
+// Общий для всего приложения пул потоков. У каждого потока своя очередь:
+// свои задачи он берет с конца, а опустев, крадет чужие с начала. Задачи
+// Interactive (отрисовка, предпросмотр, ответ на действие пользователя)
+// выбираются раньше Background (построение индексов впрок).
+class Scheduler {
+ public:
+  enum Priority { Interactive, Background };
+
+  typedef std::function<void()> Task;
+
+  // Больше потоков не создается, настройка ограничивается этим числом.
+  static constexpr size_t maxThreadsNumber = 64;
+
+  static Scheduler &instance();
+
+  ~Scheduler();
+
+  // Число потоков, выполняющих задачи параллельно, вместе с вызывающим
+  // parallelFor.
+  size_t threadsNumber() const;
+
+  // Недостающие потоки создаются, лишние засыпают после текущей задачи, их
+  // очереди разбирают остальные. Можно вызывать во время вычислений.
+  void setThreadsNumber(size_t threadsNumber);
+
+  void submit(Task task, Priority priority = Background);
+
+  // Выполняет function(i) для i из [begin, end) и возвращается, когда все
+  // вызовы завершены. Вызывающий поток выполняет итерации сам, поэтому
+  // вложенные вызовы из задач не блокируют пул. Первое исключение из
+  // function пробрасывается вызывающему.
+  void parallelFor(size_t begin, size_t end,
+                   const std::function<void(size_t)> &function,
+                   Priority priority = Interactive);
+
+ private:
+  Scheduler();
+
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks[2];
+  };
+
+  struct Loop;
+
+  void run(size_t index);
+  bool pop(size_t index, Task &task);
+
+  static void runLoop(const std::shared_ptr<Loop> &loop);
+
+  // Очереди создаются сразу на все потоки и не перемещаются, поэтому
+  // изменение числа потоков не мешает параллельным submit.
+  std::vector<Worker> m_workers;
+  std::vector<std::thread> m_threads;
+
+  std::atomic<size_t> m_threadsNumber{0};
+  std::atomic<size_t> m_startedNumber{0};
+
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::atomic<size_t> m_pending{0};
+  bool m_stopping = false;
+
+  std::atomic<size_t> m_nextWorker{0};
+
+  // Номер рабочего потока, из которого идет вызов, или -1.
+  static thread_local int t_workerIndex;
+};
+
+}  // namespace fssp
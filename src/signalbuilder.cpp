@@ -6,16 +6,19 @@ SignalBuilder::SignalBuilder() {}
 
 SignalPage *SignalBuilder::FromFile(const QString &absoluteFilePath,
                                     const QString &fileExtension) {
-  BaseDeserializer *deserializer;
-  if (fileExtension == "txt") {
-    deserializer = new TxtDeserializer();
-  } else {
-    throw SignalBuilder::FileTypeError();
-  }
+  std::shared_ptr<BaseDeserializer> deserializer =
+      DeserializerFor(fileExtension);
 
   SignalData data = deserializer->operator()(absoluteFilePath);
 
   return new SignalPage(data);
 }
 
+std::shared_ptr<BaseDeserializer> SignalBuilder::DeserializerFor(
+    const QString &fileExtension) {
+  if (fileExtension == "txt") return std::make_shared<TxtDeserializer>();
+
+  throw SignalBuilder::FileTypeError();
+}
+
 }  // namespace fssp
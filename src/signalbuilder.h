@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QString>
+#include <memory>
 
 #include "basedeserializer.h"
 #include "signalpage.h"
@@ -15,6 +16,10 @@ class SignalBuilder {
   static SignalPage *FromFile(const QString &absoluteFilePath,
                               const QString &fileExtension);
 
+  // Десериализатор для файлов с расширением fileExtension.
+  static std::shared_ptr<BaseDeserializer> DeserializerFor(
+      const QString &fileExtension);
+
   class FileTypeError : public std::exception {
    public:
     virtual const char *what() const throw() {
@@ -1,7 +1,29 @@
 #include "signaldata.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include "parallel.h"
+#include "resampler.h"
+
 namespace fssp {
 
+namespace {
+
+std::vector<std::shared_ptr<const ChannelSource>> storedChannels(
+    std::vector<std::vector<double>> &&data) {
+  std::vector<std::shared_ptr<const ChannelSource>> channels;
+  for (std::vector<double> &channel : data) {
+    channels.push_back(std::make_shared<StoredChannel>(std::move(channel)));
+  }
+
+  return channels;
+}
+
+}  // namespace
+
 SignalData::SignalData() {
   m_samplesNumber = 1000;
   m_rate = 1;
@@ -13,9 +35,11 @@ SignalData::SignalData() {
 
   m_channelsNumber = 1;
 
+  m_visibleWaveforms = std::vector<bool>(m_channelsNumber, false);
+
   m_channelsName = std::vector<QString>(m_channelsNumber);
-  m_data = std::vector<std::vector<double>>(
-      m_channelsNumber, std::vector<double>(m_samplesNumber));
+  m_channels = {std::make_shared<StoredChannel>(
+      std::vector<double>(m_samplesNumber))};
 
   m_leftArray = 0;
   m_rightArray = m_samplesNumber - 1;
@@ -42,7 +66,15 @@ SignalData::SignalData(const QDateTime &startTime, const QDateTime &endTime,
                        const double rate, const double timeForOne,
                        const size_t allTime,
                        std::vector<QString> &&channelsName,
-                       std::vector<std::vector<double>> &&data) {
+                       std::vector<std::vector<double>> &&data)
+    : SignalData(startTime, endTime, rate, timeForOne, allTime,
+                 std::move(channelsName), storedChannels(std::move(data))) {}
+
+SignalData::SignalData(
+    const QDateTime &startTime, const QDateTime &endTime, const double rate,
+    const double timeForOne, const size_t allTime,
+    std::vector<QString> &&channelsName,
+    std::vector<std::shared_ptr<const ChannelSource>> &&channels) {
   m_startTime = startTime;
   m_endTime = endTime;
 
@@ -51,10 +83,12 @@ SignalData::SignalData(const QDateTime &startTime, const QDateTime &endTime,
   m_allTime = allTime;
 
   m_channelsName = std::move(channelsName);
-  m_data = std::move(data);
+  m_channels = std::move(channels);
 
   m_channelsNumber = m_channelsName.size();
-  m_samplesNumber = m_data[0].size();
+  m_samplesNumber = m_channels[0]->size();
+
+  m_visibleWaveforms = std::vector<bool>(m_channelsNumber, false);
 
   m_leftArray = 0;
   m_rightArray = m_samplesNumber - 1;
@@ -86,7 +120,9 @@ SignalData::SignalData(const SignalData &that) {
   m_allTime = that.m_allTime;
 
   m_channelsName = that.m_channelsName;
-  m_data = that.m_data;
+  m_channels = that.m_channels;
+  m_momentIndexes = that.m_momentIndexes;
+  m_quantileIndexes = that.m_quantileIndexes;
 
   m_channelsNumber = that.m_channelsNumber;
   m_samplesNumber = that.m_samplesNumber;
@@ -123,7 +159,9 @@ SignalData::SignalData(SignalData &&that) {
   m_allTime = that.m_allTime;
 
   m_channelsName = std::move(that.m_channelsName);
-  m_data = std::move(that.m_data);
+  m_channels = std::move(that.m_channels);
+  m_momentIndexes = std::move(that.m_momentIndexes);
+  m_quantileIndexes = std::move(that.m_quantileIndexes);
 
   m_channelsNumber = that.m_channelsNumber;
   m_samplesNumber = that.m_samplesNumber;
@@ -168,7 +206,9 @@ void swap(SignalData &first, SignalData &second) {
   swap(first.m_allTime, second.m_allTime);
 
   swap(first.m_channelsName, second.m_channelsName);
-  swap(first.m_data, second.m_data);
+  swap(first.m_channels, second.m_channels);
+  swap(first.m_momentIndexes, second.m_momentIndexes);
+  swap(first.m_quantileIndexes, second.m_quantileIndexes);
 
   swap(first.m_channelsNumber, second.m_channelsNumber);
   swap(first.m_samplesNumber, second.m_samplesNumber);
@@ -224,22 +264,267 @@ bool SignalData::isGlobalScale() const { return m_isGlobalScale; }
 
 bool SignalData::isSelected() const { return m_isSelected; }
 
+bool SignalData::isPanning() const { return m_isPanning; }
+
 const std::vector<QString> &SignalData::channelsName() const {
   return m_channelsName;
 }
 
-const std::vector<std::vector<double>> &SignalData::data() const {
-  return m_data;
+std::shared_ptr<const ChannelSource> SignalData::channel(int channel) const {
+  std::lock_guard<std::mutex> lock(m_channelsMutex);
+  return m_channels[channel];
+}
+
+void SignalData::read(int channel, size_t start, size_t count,
+                      double *output) const {
+  this->channel(channel)->read(start, count, output);
+}
+
+std::vector<double> SignalData::channelData(int channel) const {
+  return channelData(channel, 0, this->channel(channel)->size());
+}
+
+std::vector<double> SignalData::channelData(int channel, size_t start,
+                                            size_t count) const {
+  std::vector<double> data(count);
+  this->channel(channel)->read(start, count, data.data());
+
+  return data;
+}
+
+void SignalData::channelRange(int channel, size_t start, size_t count,
+                              double &min, double &max) const {
+  min = std::numeric_limits<double>::infinity();
+  max = -std::numeric_limits<double>::infinity();
+
+  std::shared_ptr<const ChannelSource> sourcePointer = this->channel(channel);
+  const ChannelSource &source = *sourcePointer;
+
+  if (const double *samples = source.samples()) {
+    if (!count) return;
+    auto [minIt, maxIt] =
+        std::minmax_element(samples + start, samples + start + count);
+    min = *minIt;
+    max = *maxIt;
+    return;
+  }
+
+  std::vector<double> block;
+  for (size_t done = 0; done < count;) {
+    size_t length = std::min(ProceduralChannel::blockSize, count - done);
+    block.resize(length);
+    source.read(start + done, length, block.data());
+
+    auto [minIt, maxIt] = std::minmax_element(block.begin(), block.end());
+    min = std::min(min, *minIt);
+    max = std::max(max, *maxIt);
+
+    done += length;
+  }
+}
+
+Moments SignalData::channelMoments(int channel, size_t start,
+                                   size_t count) const {
+  return momentIndex(channel)->moments(*this->channel(channel), start, count);
+}
+
+bool SignalData::hasMomentIndex(int channel) const {
+  std::lock_guard<std::mutex> lock(m_momentIndexesMutex);
+
+  if (m_momentIndexes.size() <= static_cast<size_t>(channel)) return false;
+
+  const auto &slot = m_momentIndexes[channel];
+  return slot.valid() &&
+         slot.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+std::shared_ptr<const MomentIndex> SignalData::momentIndex(int channel) const {
+  return index(m_momentIndexes, m_momentIndexesMutex, channel);
+}
+
+std::vector<double> SignalData::channelQuantiles(
+    int channel, size_t start, size_t count,
+    const std::vector<double> &orders) const {
+  if (count <= QuantileIndex::exactLimit) {
+    return QuantileIndex::exactQuantiles(*this->channel(channel), start,
+                                         count, orders);
+  }
+
+  return quantileIndex(channel)->quantiles(*this->channel(channel), start,
+                                           count, orders);
+}
+
+std::shared_ptr<const QuantileIndex> SignalData::quantileIndex(
+    int channel) const {
+  std::shared_ptr<const QuantileIndex> quantileIndex =
+      index(m_quantileIndexes, m_quantileIndexesMutex, channel);
+  if (quantileIndex->compression() == QuantileIndex::defaultCompression()) {
+    return quantileIndex;
+  }
+
+  // Точность изменили в настройках после построения, индекс строится
+  // заново, если другой поток еще не сделал этого.
+  {
+    std::lock_guard<std::mutex> lock(m_quantileIndexesMutex);
+
+    auto &slot = m_quantileIndexes[channel];
+    if (slot.valid() &&
+        slot.wait_for(std::chrono::seconds(0)) == std::future_status::ready &&
+        slot.get() == quantileIndex) {
+      slot = {};
+    }
+  }
+
+  return index(m_quantileIndexes, m_quantileIndexesMutex, channel);
+}
+
+template <typename Index>
+std::shared_ptr<const Index> SignalData::index(IndexSlots<Index> &slots,
+                                               std::mutex &mutex,
+                                               int channel) const {
+  std::promise<std::shared_ptr<const Index>> promise;
+  std::shared_future<std::shared_ptr<const Index>> future;
+  bool isBuilder = false;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    size_t size = channel + 1;
+    if (slots.size() < size) slots.resize(size);
+
+    if (!slots[channel].valid()) {
+      slots[channel] = promise.get_future().share();
+      isBuilder = true;
+    }
+    future = slots[channel];
+  }
+
+  // Индекс строится вне блокировки, запросы к другим каналам не ждут.
+  if (isBuilder) {
+    try {
+      promise.set_value(
+          std::make_shared<const Index>(*this->channel(channel)));
+    } catch (...) {
+      // Следующий запрос попробует построить индекс заново. Слот
+      // освобождается раньше, чем future получит исключение, поэтому
+      // готовый future в слоте всегда содержит индекс.
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        slots[channel] = {};
+      }
+      promise.set_exception(std::current_exception());
+    }
+  }
+
+  return future.get();
+}
+
+Histogram SignalData::channelHistogram(int channel, size_t start,
+                                      size_t count,
+                                      const Histogram &histogram) const {
+  std::shared_ptr<const ChannelSource> sourcePointer = this->channel(channel);
+  const ChannelSource &source = *sourcePointer;
+
+  size_t blockSize = ProceduralChannel::blockSize;
+  size_t blocksNumber = (count + blockSize - 1) / blockSize;
+
+  // Каждая часть - несколько соседних блоков со своей гистограммой.
+  return parallelReduce(
+      0, blocksNumber, histogram.empty(),
+      [&](Histogram &part, size_t i) {
+        size_t from = start + i * blockSize;
+        size_t length = std::min(blockSize, start + count - from);
+
+        if (const double *samples = source.samples()) {
+          part.add(samples + from, length);
+          return;
+        }
+
+        std::vector<double> block(length);
+        source.read(from, length, block.data());
+        part.add(block.data(), length);
+      },
+      [](Histogram &result, const Histogram &part) { result.merge(part); });
+}
+
+std::vector<double> SignalData::envelope(int channel, size_t start,
+                                         size_t count, size_t columns) const {
+  if (!count || !columns) return {};
+
+  columns = std::min(columns, count);
+  std::vector<double> result(2 * columns);
+
+  parallelFor(0, columns, [&](size_t i) {
+    size_t from = start + count * i / columns;
+    size_t to = start + count * (i + 1) / columns;
+
+    channelRange(channel, from, to - from, result[2 * i], result[2 * i + 1]);
+  });
+
+  return result;
 }
 
 void SignalData::addData(const QString name, std::vector<double> data) {
-  ++m_channelsNumber;
-  m_channelsName.push_back(name);
-  m_data.push_back(data);
+  addChannel(name, std::make_shared<StoredChannel>(std::move(data)));
+}
+
+void SignalData::addChannel(const QString name,
+                            std::shared_ptr<const ChannelSource> channel) {
+  {
+    std::lock_guard<std::mutex> lock(m_channelsMutex);
+    ++m_channelsNumber;
+    m_channelsName.push_back(name);
+    m_channels.push_back(std::move(channel));
+  }
   m_visibleWaveforms.push_back(false);
 }
 
-int SignalData::channelsNumber() const { return m_channelsNumber; }
+SignalData SignalData::resampled(int upFactor, int downFactor) const {
+  std::vector<std::vector<double>> data(m_channelsNumber);
+  for (int i = 0; i < m_channelsNumber; ++i) {
+    data[i] = Resampler::resample(channelData(i), upFactor, downFactor);
+  }
+
+  std::vector<QString> channelsName = m_channelsName;
+
+  double rate = m_rate * upFactor / downFactor;
+  double timeForOne = 1. / rate;
+  size_t allTime = (timeForOne * data[0].size()) * 1000;
+
+  return SignalData(m_startTime, m_startTime.addMSecs(allTime), rate,
+                    timeForOne, allTime, std::move(channelsName),
+                    std::move(data));
+}
+
+std::vector<double> SignalData::conformChannel(const SignalData &source,
+                                               int channel) const {
+  std::vector<double> data = source.channelData(channel);
+
+  if (source.rate() != m_rate) {
+    int upFactor;
+    int downFactor;
+    Resampler::approximateRatio(m_rate / source.rate(), upFactor, downFactor);
+
+    data = Resampler::resample(data, upFactor, downFactor);
+  }
+
+  // Выравнивание по времени начала записи.
+  qint64 offset =
+      std::llround(m_startTime.msecsTo(source.startTime()) * m_rate / 1000.);
+
+  std::vector<double> result(m_samplesNumber, 0.);
+  for (qint64 i = std::max<qint64>(0, -offset); i < (qint64)data.size(); ++i) {
+    if (i + offset >= m_samplesNumber) break;
+    result[i + offset] = data[i];
+  }
+
+  return result;
+}
+
+int SignalData::channelsNumber() const {
+  std::lock_guard<std::mutex> lock(m_channelsMutex);
+  return m_channelsNumber;
+}
 
 int SignalData::samplesNumber() const { return m_samplesNumber; }
 
@@ -261,6 +546,28 @@ void SignalData::setGlobalScale(bool isGlobalScale) {
 
 void SignalData::setSelected(bool isSelected) { m_isSelected = isSelected; }
 
+void SignalData::setPanning(bool isPanning) { m_isPanning = isPanning; }
+
+bool SignalData::panArrayRange(int delta) {
+  int range = m_rightArray - m_leftArray;
+  int left = std::clamp(m_leftArray + delta, 0,
+                        std::max(0, m_samplesNumber - 1 - range));
+
+  if (left == m_leftArray) return false;
+
+  // Длина в отсчетах не меняется, поэтому масштаб графиков тот же.
+  m_leftArray = left;
+  m_rightArray = left + range;
+
+  double timePerData =
+      static_cast<double>(m_allTime) / static_cast<double>(m_samplesNumber);
+
+  m_leftTime = timePerData * m_leftArray;
+  m_rightTime = timePerData * m_rightArray;
+
+  return true;
+}
+
 void SignalData::setLeftArray(int leftArray) { m_leftArray = leftArray; }
 
 void SignalData::setRightArray(int rightArray) { m_rightArray = rightArray; }
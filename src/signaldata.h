@@ -1,6 +1,15 @@
 #pragma once
 
 #include <QDateTime>
+#include <future>
+#include <memory>
+#include <mutex>
+
+#include "channelsource.h"
+#include "histogram.h"
+#include "momentindex.h"
+#include "moments.h"
+#include "quantileindex.h"
 
 namespace fssp {
 
@@ -14,6 +23,12 @@ class SignalData : public QObject {
                       const size_t allTime, std::vector<QString> &&channelsName,
                       std::vector<std::vector<double>> &&data);
 
+  explicit SignalData(
+      const QDateTime &startTime, const QDateTime &endTime, const double rate,
+      const double timeForOne, const size_t allTime,
+      std::vector<QString> &&channelsName,
+      std::vector<std::shared_ptr<const ChannelSource>> &&channels);
+
   SignalData(const SignalData &that);
 
   SignalData(SignalData &&that);
@@ -43,6 +58,9 @@ class SignalData : public QObject {
   bool isGlobalScale() const;
   bool isSelected() const;
 
+  // Пока идет сдвиг вида, масштаб по вертикали остается прежним.
+  bool isPanning() const;
+
   void setLeftArray(int leftArray);
   void setRightArray(int rightArray);
 
@@ -52,6 +70,11 @@ class SignalData : public QObject {
   void setGridEnabled(bool isGridEnabled);
   void setGlobalScale(bool isGlobalScale);
   void setSelected(bool isSelected);
+  void setPanning(bool isPanning);
+
+  // Сдвигает диапазон отсчетов на delta с той же длиной, время
+  // пересчитывается по нему. Возвращает false, если сдвигать некуда.
+  bool panArrayRange(int delta);
 
   int spectrumLeftArray() const;
   int spectrumRightArray() const;
@@ -85,10 +108,57 @@ class SignalData : public QObject {
   void calculateArrayRange();
   void spectrumCalculateArrayRange();
 
+  // Ссылка на список имен действительна только в потоке окна: фоновые
+  // задачи получают копии имен и указатели на каналы до запуска.
   const std::vector<QString> &channelsName() const;
-  const std::vector<std::vector<double>> &data() const;
+  std::shared_ptr<const ChannelSource> channel(int channel) const;
+
+  void read(int channel, size_t start, size_t count, double *output) const;
+
+  std::vector<double> channelData(int channel) const;
+  std::vector<double> channelData(int channel, size_t start,
+                                  size_t count) const;
+
+  // Минимум и максимум отсчетов [start, start + count) без копирования
+  // всего диапазона.
+  void channelRange(int channel, size_t start, size_t count, double &min,
+                    double &max) const;
+
+  // Моменты отсчетов [start, start + count). При первом обращении к
+  // каналу строится его MomentIndex, после этого запрос почти не читает
+  // отсчеты.
+  Moments channelMoments(int channel, size_t start, size_t count) const;
+  // Построен ли уже MomentIndex канала, то есть не будет ли channelMoments
+  // ждать его построения.
+  bool hasMomentIndex(int channel) const;
+
+  // Квантили порядков orders отсчетов [start, start + count). Короткие
+  // диапазоны обрабатываются точно, для длинных при первом обращении
+  // строится QuantileIndex канала и результат приближенный, с точностью
+  // из QuantileIndex::defaultCompression().
+  std::vector<double> channelQuantiles(int channel, size_t start, size_t count,
+                                       const std::vector<double> &orders) const;
+
+  // Гистограмма отсчетов [start, start + count) с интервалами histogram.
+  // Потоки заполняют собственные гистограммы, которые затем объединяются.
+  Histogram channelHistogram(int channel, size_t start, size_t count,
+                             const Histogram &histogram) const;
+
+  // Пары минимум/максимум для columns равных частей диапазона - для
+  // отрисовки длинных каналов без чтения всех отсчетов в память.
+  std::vector<double> envelope(int channel, size_t start, size_t count,
+                               size_t columns) const;
 
   void addData(const QString name, std::vector<double> data);
+  void addChannel(const QString name,
+                  std::shared_ptr<const ChannelSource> channel);
+
+  SignalData resampled(int upFactor, int downFactor) const;
+  // Канал source, передискретизированный к частоте и выровненный по
+  // времени начала этого сигнала. Если частоты отличаются больше чем в 1000
+  // раз, бросает Resampler::UnsupportedRatio.
+  std::vector<double> conformChannel(const SignalData &source,
+                                     int channel) const;
 
   int channelsNumber() const;
   int samplesNumber() const;
@@ -102,6 +172,9 @@ class SignalData : public QObject {
  signals:
   void changedGraphTimeRange();
 
+  // Выделение еще изменяется (пользователь тянет мышь).
+  void changingGraphTimeRange(size_t leftArray, size_t rightArray);
+
   void changedWaveformVisibility();
 
   void changedEnableGrid();
@@ -126,7 +199,31 @@ class SignalData : public QObject {
   size_t m_allTime;
 
   std::vector<QString> m_channelsName;
-  std::vector<std::vector<double>> m_data;
+  std::vector<std::shared_ptr<const ChannelSource>> m_channels;
+
+  // Каналы читаются и из фоновых задач, пока окно может добавить новый.
+  // Защищает m_channels, m_channelsName и m_channelsNumber.
+  mutable std::mutex m_channelsMutex;
+
+  template <typename Index>
+  using IndexSlots =
+      std::vector<std::shared_future<std::shared_ptr<const Index>>>;
+
+  std::shared_ptr<const MomentIndex> momentIndex(int channel) const;
+  std::shared_ptr<const QuantileIndex> quantileIndex(int channel) const;
+
+  template <typename Index>
+  std::shared_ptr<const Index> index(IndexSlots<Index> &slots,
+                                     std::mutex &mutex, int channel) const;
+
+  // Строятся по запросу. Каналы не изменяются, поэтому индексы общие у
+  // копий SignalData. Мьютекс защищает только слоты: индекс строит первый
+  // запросивший поток, остальные ждут future своего канала.
+  mutable IndexSlots<MomentIndex> m_momentIndexes;
+  mutable std::mutex m_momentIndexesMutex;
+
+  mutable IndexSlots<QuantileIndex> m_quantileIndexes;
+  mutable std::mutex m_quantileIndexesMutex;
 
   int m_channelsNumber;
   int m_samplesNumber;
@@ -141,6 +238,9 @@ class SignalData : public QObject {
   bool m_isGlobalScale;
   bool m_isSelected;
 
+  // Состояние жеста в окне, при копировании не переносится.
+  bool m_isPanning = false;
+
   bool m_spectrumIsGridEnabled;
   bool m_spectrumIsGlobalScale;
   bool m_spectrumIsSelected;
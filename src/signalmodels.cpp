@@ -1,13 +1,27 @@
 #include "signalmodels.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <limits>
+#include <random>
 
+#include "armafilter.h"
+#include "expression.h"
+#include "oscillator.h"
 #include "qspinbox.h"
+#include "random.h"
 
 namespace fssp {
 
+namespace {
+
+int randomSeed() {
+  return std::random_device{}() & std::numeric_limits<int>::max();
+}
+
+}  // namespace
+
 //
 
 DelayedSingleImpulseModel::DelayedSingleImpulseModel(
@@ -16,18 +30,18 @@ DelayedSingleImpulseModel::DelayedSingleImpulseModel(
   delaySpinBox = addSpinBox(tr("Delay:"), signalData->samplesNumber() / 3);
 }
 
-void DelayedSingleImpulseModel::calc() {
-  int n = p_sampleNumberSpinBox->value();
+ProceduralChannel::Generator DelayedSingleImpulseModel::generator() const {
   int n_0 = delaySpinBox->value();
-  p_data = std::vector<double>(n);
 
-  for (int i = 0; i < n; ++i) {
-    if (i == n_0) {
-      p_data[i] = 1.;
-    } else {
-      p_data[i] = 0;
+  return [n_0](double *output, size_t start, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      if (static_cast<long long>(start + i) == n_0) {
+        output[i] = 1.;
+      } else {
+        output[i] = 0;
+      }
     }
-  }
+  };
 }
 
 //
@@ -38,18 +52,18 @@ DelayedSingleJumpModel::DelayedSingleJumpModel(
   delaySpinBox = addSpinBox(tr("Delay:"), signalData->samplesNumber() / 3);
 }
 
-void DelayedSingleJumpModel::calc() {
-  int n = p_sampleNumberSpinBox->value();
+ProceduralChannel::Generator DelayedSingleJumpModel::generator() const {
   int n_0 = delaySpinBox->value();
-  p_data = std::vector<double>(n);
 
-  for (int i = 0; i < n; ++i) {
-    if (i >= n_0) {
-      p_data[i] = 1.;
-    } else {
-      p_data[i] = 0;
+  return [n_0](double *output, size_t start, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      if (static_cast<long long>(start + i) >= n_0) {
+        output[i] = 1.;
+      } else {
+        output[i] = 0;
+      }
     }
-  }
+  };
 }
 
 //
@@ -62,14 +76,14 @@ DiscretDecreasingExpModel::DiscretDecreasingExpModel(
       std::pow(1. / 10., 1. / ((double)signalData->samplesNumber() - 1)));
 }
 
-void DiscretDecreasingExpModel::calc() {
-  int n = p_sampleNumberSpinBox->value();
+ProceduralChannel::Generator DiscretDecreasingExpModel::generator() const {
   double a = expBaseSpinBox->value();
-  p_data = std::vector<double>(n);
 
-  for (int i = 0; i < n; ++i) {
-    p_data[i] = std::pow(a, i);
-  }
+  return [a](double *output, size_t start, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      output[i] = std::pow(a, static_cast<double>(start + i));
+    }
+  };
 }
 
 //
@@ -84,17 +98,16 @@ DiscretSinModel::DiscretSinModel(std::shared_ptr<SignalData> signalData,
   amplitudeSpinBox = addDoubleSpinBox(tr("Amplitude:"), 1);
 }
 
-void DiscretSinModel::calc() {
-  int n = p_sampleNumberSpinBox->value();
-  p_data = std::vector<double>(n);
-
+ProceduralChannel::Generator DiscretSinModel::generator() const {
   double a = amplitudeSpinBox->value();
   double w = circFreqSpinBox->value();
   double p = initPhaseSpinBox->value();
 
-  for (int i = 0; i < n; ++i) {
-    p_data[i] = a * std::sin(i * w + p);
-  }
+  // sin(x) = cos(x - pi / 2)
+  Oscillator oscillator(a, w, p - M_PI / 2);
+  return [oscillator](double *output, size_t start, size_t count) {
+    oscillator.generate(output, start, count);
+  };
 }
 
 //
@@ -102,38 +115,41 @@ void DiscretSinModel::calc() {
 RectGridModel::RectGridModel(std::shared_ptr<SignalData> signalData,
                              QWidget *parent)
     : BaseModel{signalData, parent} {
-  periodSpinBox = addSpinBox(tr("Period:"), signalData->samplesNumber() / 15);
+  // Период 0 дал бы деление на ноль в генераторе.
+  periodSpinBox = addSpinBox(tr("Period:"),
+                             std::max(1, signalData->samplesNumber() / 15), 1);
 }
 
-void RectGridModel::calc() {
-  int n = p_sampleNumberSpinBox->value();
+ProceduralChannel::Generator RectGridModel::generator() const {
   double L = periodSpinBox->value();
-  p_data = std::vector<double>(n);
 
-  for (int i = 0; i < n; ++i) {
-    if ((i % static_cast<int>(L)) < (L / 2)) {
-      p_data[i] = 1;
-    } else {
-      p_data[i] = -1;
+  return [L](double *output, size_t start, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      if (((start + i) % static_cast<size_t>(L)) < (L / 2)) {
+        output[i] = 1;
+      } else {
+        output[i] = -1;
+      }
     }
-  }
+  };
 }
 
 //
 
 SawModel::SawModel(std::shared_ptr<SignalData> signalData, QWidget *parent)
     : BaseModel{signalData, parent} {
-  periodSpinBox = addSpinBox(tr("Period:"), signalData->samplesNumber() / 15);
+  periodSpinBox = addSpinBox(tr("Period:"),
+                             std::max(1, signalData->samplesNumber() / 15), 1);
 }
 
-void SawModel::calc() {
-  int n = p_sampleNumberSpinBox->value();
+ProceduralChannel::Generator SawModel::generator() const {
   double L = periodSpinBox->value();
-  p_data = std::vector<double>(n);
 
-  for (int i = 0; i < n; ++i) {
-    p_data[i] = (i % static_cast<int>(L)) / L;
-  }
+  return [L](double *output, size_t start, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      output[i] = ((start + i) % static_cast<size_t>(L)) / L;
+    }
+  };
 }
 
 //
@@ -151,20 +167,17 @@ ExpEnvelopeModel::ExpEnvelopeModel(std::shared_ptr<SignalData> signalData,
   initPhaseSpinBox = addDoubleSpinBox(tr("Init phase:"), 0);
 }
 
-void ExpEnvelopeModel::calc() {
-  int n = p_sampleNumberSpinBox->value();
-  p_data = std::vector<double>(n);
-
+ProceduralChannel::Generator ExpEnvelopeModel::generator() const {
   double a = amplitudeSpinBox->value();
   double t = envelopeWidthSpinBox->value();
   double f = carrierFreqSpinBox->value();
   double p = initPhaseSpinBox->value();
   double T = p_freqSpinBox->value();
-  double f_d = 1.0 / T;
 
-  for (int i = 0; i < n; ++i) {
-    p_data[i] = a * std::exp((-i * T) / t) * std::cos(2 * M_PI * f * i * T + p);
-  }
+  Oscillator oscillator(a, 2 * M_PI * f * T, p, T / t);
+  return [oscillator](double *output, size_t start, size_t count) {
+    oscillator.generate(output, start, count);
+  };
 }
 
 //
@@ -182,20 +195,23 @@ BalanceEnvelopeModel::BalanceEnvelopeModel(
   initPhaseSpinBox = addDoubleSpinBox(tr("Init phase:"), 0);
 }
 
-void BalanceEnvelopeModel::calc() {
-  int n = p_sampleNumberSpinBox->value();
-  p_data = std::vector<double>(n);
-
+ProceduralChannel::Generator BalanceEnvelopeModel::generator() const {
   double a = amplitudeSpinBox->value();
   double f_n = freqEnvelopeSpinBox->value();
   double f_0 = carrierFreqSpinBox->value();
   double p = initPhaseSpinBox->value();
   double T = p_freqSpinBox->value();
 
-  for (int i = 0; i < n; ++i) {
-    p_data[i] = a * std::cos(2 * M_PI * f_0 * i * T) *
-                std::cos(2 * M_PI * f_n * i * T + p);
-  }
+  double w_0 = 2 * M_PI * f_0 * T;
+  double w_n = 2 * M_PI * f_n * T;
+
+  // Произведение косинусов раскладывается в сумму двух колебаний.
+  Oscillator upper(a / 2, w_n + w_0, p);
+  Oscillator lower(a / 2, w_n - w_0, p);
+  return [upper, lower](double *output, size_t start, size_t count) {
+    upper.generate(output, start, count);
+    lower.accumulate(output, start, count);
+  };
 }
 
 //
@@ -214,10 +230,7 @@ TonalEnvelopeModel::TonalEnvelopeModel(std::shared_ptr<SignalData> signalData,
   modulationDepthIndexSpinBox = addDoubleSpinBox(tr("Modulation depth:"), 0.5);
 }
 
-void TonalEnvelopeModel::calc() {
-  int n = p_sampleNumberSpinBox->value();
-  p_data = std::vector<double>(n);
-
+ProceduralChannel::Generator TonalEnvelopeModel::generator() const {
   double a = amplitudeSpinBox->value();
   double f_n = freqEnvelopeSpinBox->value();
   double f_0 = carrierFreqSpinBox->value();
@@ -225,10 +238,18 @@ void TonalEnvelopeModel::calc() {
   double m = modulationDepthIndexSpinBox->value();
   double T = p_freqSpinBox->value();
 
-  for (int i = 0; i < n; ++i) {
-    p_data[i] = a * (1 + m * std::cos(2 * M_PI * f_0 * i * T)) *
-                std::cos(2 * M_PI * f_n * i * T + p);
-  }
+  double w_0 = 2 * M_PI * f_0 * T;
+  double w_n = 2 * M_PI * f_n * T;
+
+  Oscillator carrier(a, w_n, p);
+  Oscillator upper(a * m / 2, w_n + w_0, p);
+  Oscillator lower(a * m / 2, w_n - w_0, p);
+  return [carrier, upper, lower](double *output, size_t start,
+                                 size_t count) {
+    carrier.generate(output, start, count);
+    upper.accumulate(output, start, count);
+    lower.accumulate(output, start, count);
+  };
 }
 
 //
@@ -246,9 +267,8 @@ LinearFreqModulationModel::LinearFreqModulationModel(
       20 * signalData->rate() / (double)signalData->samplesNumber());
 }
 
-void LinearFreqModulationModel::calc() {
+ProceduralChannel::Generator LinearFreqModulationModel::generator() const {
   int n = p_sampleNumberSpinBox->value();
-  p_data = std::vector<double>(n);
 
   double a = amplitudeSpinBox->value();
   double f_k = finishFreqSpinBox->value();
@@ -257,11 +277,11 @@ void LinearFreqModulationModel::calc() {
   double T = p_freqSpinBox->value();
   double T_max = T * n;
 
-  for (int i = 0; i < n; ++i) {
-    p_data[i] =
-        a *
-        std::cos(2 * M_PI * (f_0 + (i * T) * (f_k - f_0) / T_max) * i * T + p);
-  }
+  ChirpOscillator oscillator(a, 2 * M_PI * T * T * (f_k - f_0) / T_max,
+                             2 * M_PI * f_0 * T, p);
+  return [oscillator](double *output, size_t start, size_t count) {
+    oscillator.generate(output, start, count);
+  };
 }
 
 //
@@ -269,22 +289,19 @@ void LinearFreqModulationModel::calc() {
 WhiteNoiseModel::WhiteNoiseModel(std::shared_ptr<SignalData> signalData,
                                  QWidget *parent)
     : BaseModel{signalData, parent} {
-  srand(time(nullptr));
-
   minSpinBox = addDoubleSpinBox(tr("Minimum:"), -5);
   maxSpinBox = addDoubleSpinBox(tr("Maximum:"), 5);
+  seedSpinBox = addSpinBox(tr("Seed:"), randomSeed(), 0);
 }
 
-void WhiteNoiseModel::calc() {
-  int n = p_sampleNumberSpinBox->value();
-  p_data = std::vector<double>(n);
-
-  int a = minSpinBox->value();
-  int b = maxSpinBox->value();
+ProceduralChannel::Generator WhiteNoiseModel::generator() const {
+  double a = minSpinBox->value();
+  double b = maxSpinBox->value();
+  int seed = seedSpinBox->value();
 
-  for (int i = 0; i < n; ++i) {
-    p_data[i] = a + (b - a) * (rand() / (double)RAND_MAX);
-  }
+  return [a, b, seed](double *output, size_t start, size_t count) {
+    Random::fillUniform(output, seed, start, count, a, b);
+  };
 }
 
 //
@@ -292,27 +309,19 @@ void WhiteNoiseModel::calc() {
 NormalWhiteNoiseModel::NormalWhiteNoiseModel(
     std::shared_ptr<SignalData> signalData, QWidget *parent)
     : BaseModel{signalData, parent} {
-  srand(time(nullptr));
-
   averageSpinBox = addDoubleSpinBox(tr("Average value:"), 1);
   dispersionSpinBox = addDoubleSpinBox(tr("Dispersion:"), 1);
+  seedSpinBox = addSpinBox(tr("Seed:"), randomSeed(), 0);
 }
 
-void NormalWhiteNoiseModel::calc() {
-  int n = p_sampleNumberSpinBox->value();
-  p_data = std::vector<double>(n);
-
-  int a = averageSpinBox->value();
-  int q_2 = dispersionSpinBox->value();
-
-  for (int i = 0; i < n; ++i) {
-    double nu = -6;
-    for (int j = 0; j < 12; ++j) {
-      nu += (rand() / (double)RAND_MAX);
-    }
+ProceduralChannel::Generator NormalWhiteNoiseModel::generator() const {
+  double a = averageSpinBox->value();
+  double q_2 = dispersionSpinBox->value();
+  int seed = seedSpinBox->value();
 
-    p_data[i] = a + sqrt(q_2) * nu;
-  }
+  return [a, q_2, seed](double *output, size_t start, size_t count) {
+    Random::fillNormal(output, seed, start, count, a, std::sqrt(q_2));
+  };
 }
 
 //
@@ -320,23 +329,20 @@ void NormalWhiteNoiseModel::calc() {
 MovingAverageAutoregressModel::MovingAverageAutoregressModel(
     std::shared_ptr<SignalData> signalData, QWidget *parent)
     : BaseModel{signalData, parent} {
-  srand(time(nullptr));
-
   autoregressionLineEdit = addLineEdit(tr("MA Coefficients:"), 1);
   averageLineEdit = addLineEdit(tr("AR Coefficients:"), 1);
 
   dispersionSpinBox = addDoubleSpinBox(tr("Dispersion:"), 1);
+  seedSpinBox = addSpinBox(tr("Seed:"), randomSeed(), 0);
 }
 
-void MovingAverageAutoregressModel::calc() {
+BaseModel::Computation MovingAverageAutoregressModel::computation() const {
   int n = p_sampleNumberSpinBox->value();
   double q_2 = dispersionSpinBox->value();
-
-  std::vector<double> normalWhiteNoise = std::vector<double>(n);
+  int seed = seedSpinBox->value();
 
   std::vector<double> p_coef;
   std::vector<double> q_coef;
-  p_data = std::vector<double>(n);
 
   static QRegularExpression separatorRegex("[,\\s]+");
 
@@ -347,8 +353,6 @@ void MovingAverageAutoregressModel::calc() {
     p_coef.push_back(value.toDouble());
   }
 
-  int p = values.size();
-
   input = averageLineEdit->text();
   values = input.split(separatorRegex);
 
@@ -356,38 +360,95 @@ void MovingAverageAutoregressModel::calc() {
     q_coef.push_back(value.toDouble());
   }
 
-  int q = values.size();
+  return [n, q_2, seed, p_coef, q_coef](const std::atomic<bool> &cancelled) {
+    std::vector<double> data(n);
+
+    // Шум пишется блоками прямо в data и фильтруется на месте.
+    ArmaFilter filter(q_coef, p_coef);
+
+    for (size_t start = 0; start < data.size(); start += Random::blockSize) {
+      if (cancelled) break;
+
+      double *block = data.data() + start;
+      size_t count = std::min(Random::blockSize, data.size() - start);
 
-  for (quint64 i = 0; i < n; ++i) {
-    double nu = -6;
-    for (size_t j = 0; j < 12; ++j) {
-      nu += (rand() / (double)RAND_MAX);
+      Random::fillNormal(block, seed, start, count, 0, std::sqrt(q_2));
+      filter.process(block, count, block);
     }
 
-    normalWhiteNoise[i] = sqrt(q_2) * nu;
+    return data;
+  };
+}
+
+//
+
+FormulaModel::FormulaModel(std::shared_ptr<SignalData> signalData,
+                           QWidget *parent)
+    : BaseModel{signalData, parent} {
+  sourceData = signalData;
+
+  formulaLineEdit = addLineEdit(tr("Formula:"), "0.5*sin(2*pi*10*t)");
+  formulaLineEdit->setToolTip(
+      tr("Variables: n, t, fs, pi, e and channel names or ch1, ch2, ..."));
+
+  errorLabel = new QLabel();
+  errorLabel->setStyleSheet("color: red");
+  p_formLayout->addRow(errorLabel);
+}
+
+std::shared_ptr<const Expression> FormulaModel::expression() const {
+  std::vector<std::string> names;
+  for (const QString &name : sourceData->channelsName()) {
+    names.push_back(name.toStdString());
   }
 
-  for (int i = 0; i < n; ++i) {
-    double sum1 = 0, sum2 = 0;
-    int j = 1;
-    while (j <= i) {
-      if (j - 1 == q) {
-        break;
-      }
-      sum1 += q_coef[j - 1] * normalWhiteNoise[i - j];
-      j++;
-    }
+  return std::make_shared<const Expression>(
+      formulaLineEdit->text().toStdString(), names, p_freqSpinBox->value());
+}
 
-    j = 1;
-    while (j <= i) {
-      if (j - 1 == p) {
-        break;
-      }
-      sum2 += p_coef[j - 1] * p_data[i - j];
-      j++;
-    }
-    p_data[i] = normalWhiteNoise[i] + sum1 - sum2;
+QString FormulaModel::errorString() const {
+  try {
+    expression();
+  } catch (const std::exception &error) {
+    return tr("Wrong formula: ") + error.what();
+  }
+
+  return QString();
+}
+
+ProceduralChannel::Generator FormulaModel::generator() const {
+  std::shared_ptr<const Expression> expression;
+  try {
+    expression = this->expression();
+  } catch (const std::exception &error) {
+    errorLabel->setText(error.what());
+    return nullptr;
   }
+
+  errorLabel->clear();
+
+  // Отсчеты за концом канала считаются нулевыми.
+  std::vector<std::shared_ptr<const ChannelSource>> channels(
+      sourceData->channelsNumber());
+  for (size_t input : expression->usedInputs()) {
+    channels[input] = sourceData->channel(input);
+  }
+
+  return [expression, channels](double *output, size_t start, size_t count) {
+    expression->evaluate(
+        output, start, count,
+        [&channels](size_t input, double *block, size_t first, size_t length) {
+          const ChannelSource &channel = *channels[input];
+
+          size_t available = 0;
+          if (first < channel.size()) {
+            available = std::min(length, channel.size() - first);
+            channel.read(first, available, block);
+          }
+
+          std::fill(block + available, block + length, 0.);
+        });
+  };
 }
 
 }  // namespace fssp
@@ -1,13 +1,12 @@
 #pragma once
 
-#include <stdlib.h>
-#include <time.h>
-
+#include <QLabel>
 #include <QRegularExpression>
 #include <QWidget>
 #include <cmath>
 
 #include "basemodel.h"
+#include "expression.h"
 #include "qspinbox.h"
 
 namespace fssp {
@@ -20,7 +19,7 @@ class DelayedSingleImpulseModel : public BaseModel {
   explicit DelayedSingleImpulseModel(std::shared_ptr<SignalData> signalData,
                                      QWidget *parent = nullptr);
 
-  void calc() override;
+  ProceduralChannel::Generator generator() const override;
 
  private:
   QSpinBox *delaySpinBox;
@@ -34,7 +33,7 @@ class DelayedSingleJumpModel : public BaseModel {
   explicit DelayedSingleJumpModel(std::shared_ptr<SignalData> signalData,
                                   QWidget *parent = nullptr);
 
-  void calc() override;
+  ProceduralChannel::Generator generator() const override;
 
  private:
   QSpinBox *delaySpinBox;
@@ -48,7 +47,7 @@ class DiscretDecreasingExpModel : public BaseModel {
   explicit DiscretDecreasingExpModel(std::shared_ptr<SignalData> signalData,
                                      QWidget *parent = nullptr);
 
-  void calc() override;
+  ProceduralChannel::Generator generator() const override;
 
  private:
   QDoubleSpinBox *expBaseSpinBox;
@@ -62,7 +61,7 @@ class DiscretSinModel : public BaseModel {
   explicit DiscretSinModel(std::shared_ptr<SignalData> signalData,
                            QWidget *parent = nullptr);
 
-  void calc() override;
+  ProceduralChannel::Generator generator() const override;
 
  private:
   QDoubleSpinBox *initPhaseSpinBox;
@@ -78,7 +77,7 @@ class RectGridModel : public BaseModel {
   explicit RectGridModel(std::shared_ptr<SignalData> signalData,
                          QWidget *parent = nullptr);
 
-  void calc() override;
+  ProceduralChannel::Generator generator() const override;
 
  private:
   QSpinBox *periodSpinBox;
@@ -92,7 +91,7 @@ class SawModel : public BaseModel {
   explicit SawModel(std::shared_ptr<SignalData> signalData,
                     QWidget *parent = nullptr);
 
-  void calc() override;
+  ProceduralChannel::Generator generator() const override;
 
  private:
   QSpinBox *periodSpinBox;
@@ -106,7 +105,7 @@ class ExpEnvelopeModel : public BaseModel {
   explicit ExpEnvelopeModel(std::shared_ptr<SignalData> signalData,
                             QWidget *parent = nullptr);
 
-  void calc() override;
+  ProceduralChannel::Generator generator() const override;
 
  private:
   QDoubleSpinBox *envelopeWidthSpinBox;
@@ -123,7 +122,7 @@ class BalanceEnvelopeModel : public BaseModel {
   explicit BalanceEnvelopeModel(std::shared_ptr<SignalData> signalData,
                                 QWidget *parent = nullptr);
 
-  void calc() override;
+  ProceduralChannel::Generator generator() const override;
 
  private:
   QDoubleSpinBox *freqEnvelopeSpinBox;
@@ -140,7 +139,7 @@ class TonalEnvelopeModel : public BaseModel {
   explicit TonalEnvelopeModel(std::shared_ptr<SignalData> signalData,
                               QWidget *parent = nullptr);
 
-  void calc() override;
+  ProceduralChannel::Generator generator() const override;
 
  private:
   QDoubleSpinBox *freqEnvelopeSpinBox;
@@ -158,7 +157,7 @@ class LinearFreqModulationModel : public BaseModel {
   explicit LinearFreqModulationModel(std::shared_ptr<SignalData> signalData,
                                      QWidget *parent = nullptr);
 
-  void calc() override;
+  ProceduralChannel::Generator generator() const override;
 
  private:
   QDoubleSpinBox *amplitudeSpinBox;
@@ -175,13 +174,12 @@ class WhiteNoiseModel : public BaseModel {
   explicit WhiteNoiseModel(std::shared_ptr<SignalData> signalData,
                            QWidget *parent = nullptr);
 
-  void calc() override;
+  ProceduralChannel::Generator generator() const override;
 
  private:
   QDoubleSpinBox *minSpinBox;
   QDoubleSpinBox *maxSpinBox;
-
-  double randomValue;
+  QSpinBox *seedSpinBox;
 };
 
 //
@@ -192,13 +190,12 @@ class NormalWhiteNoiseModel : public BaseModel {
   explicit NormalWhiteNoiseModel(std::shared_ptr<SignalData> signalData,
                                  QWidget *parent = nullptr);
 
-  void calc() override;
+  ProceduralChannel::Generator generator() const override;
 
  private:
   QDoubleSpinBox *averageSpinBox;
   QDoubleSpinBox *dispersionSpinBox;
-
-  double randomValue;
+  QSpinBox *seedSpinBox;
 };
 
 //
@@ -209,14 +206,35 @@ class MovingAverageAutoregressModel : public BaseModel {
   explicit MovingAverageAutoregressModel(std::shared_ptr<SignalData> signalData,
                                          QWidget *parent = nullptr);
 
-  void calc() override;
+  Computation computation() const override;
 
  private:
   QLineEdit *autoregressionLineEdit;
   QLineEdit *averageLineEdit;
   QDoubleSpinBox *dispersionSpinBox;
+  QSpinBox *seedSpinBox;
+};
+
+//
+
+// Отсчеты задаются выражением над n, t, fs и каналами сигнала.
+class FormulaModel : public BaseModel {
+  Q_OBJECT
+ public:
+  explicit FormulaModel(std::shared_ptr<SignalData> signalData,
+                        QWidget *parent = nullptr);
+
+  // Для формулы с ошибкой возвращает nullptr.
+  ProceduralChannel::Generator generator() const override;
+  QString errorString() const override;
+
+ private:
+  std::shared_ptr<const Expression> expression() const;
+
+  std::shared_ptr<SignalData> sourceData;
 
-  double randomValue;
+  QLineEdit *formulaLineEdit;
+  QLabel *errorLabel;
 };
 
 }  // namespace fssp
@@ -2,7 +2,7 @@
 
 namespace fssp {
 
-SignalPage::SignalPage(const SignalData data, QWidget *parent)
+SignalPage::SignalPage(SignalData data, QWidget *parent)
     : QWidget{parent} {
   m_signalData = std::make_shared<SignalData>(std::move(data));
 
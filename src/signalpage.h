@@ -12,7 +12,7 @@ namespace fssp {
 class SignalPage : public QWidget {
   Q_OBJECT
  public:
-  explicit SignalPage(const SignalData data, QWidget *parent = nullptr);
+  explicit SignalPage(SignalData data, QWidget *parent = nullptr);
 
   std::shared_ptr<SignalData> getSignalData();
 
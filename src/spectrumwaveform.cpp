@@ -35,12 +35,32 @@ SpectrumWaveform::SpectrumWaveform(std::shared_ptr<SignalData> signalData,
   setFocusPolicy(Qt::StrongFocus);
 }
 
+SpectrumWaveform::~SpectrumWaveform() { stopRendering(); }
+
 void SpectrumWaveform::setData(std::vector<double> &spectrumData) {
-  p_data = spectrumData;
+  m_data = spectrumData;
+  m_isDataChanged = true;
+}
+
+void SpectrumWaveform::prepareWaveform() {
+  BaseWaveform::prepareWaveform();
+
+  if (m_isDataChanged) {
+    p_data = std::move(m_data);
+    m_isDataChanged = false;
+  }
+
+  m_isTop = m_position == Top;
+  m_isBottom = m_position == Bottom;
+
+  setOffset(p_offsetLeft, p_offsetRight,
+            m_isTop ? (p_maxTextHeight + 5) * 2 : 10,
+            m_isBottom ? (p_maxTextHeight + 5) * 2 : 10);
+
   updateRelative();
 }
 
-void SpectrumWaveform::drawWaveform() {
+void SpectrumWaveform::renderWaveform() {
   initImage();
   fill();
   drawName();
@@ -54,8 +74,6 @@ void SpectrumWaveform::drawWaveform() {
 
   drawGrid();
   drawBresenham();
-
-  showWaveform();
 }
 
 void SpectrumWaveform::updateRelative() {
@@ -76,6 +94,10 @@ void SpectrumWaveform::updateRelative() {
 
   p_dataRange = std::abs(p_maxValue - p_minValue);
 
+  m_leftFreq = p_signalData->leftFreq();
+  m_freqRange = p_signalData->freqRange();
+  m_isGridEnabled = p_signalData->spectrumIsGridEnabled();
+
   p_xLabelsNumber = ((p_height - (p_offsetBottom + p_paddingBottom)) -
                      (p_offsetTop + p_paddingTop)) /
                     p_maxTextHeight;
@@ -90,36 +112,18 @@ void SpectrumWaveform::updateRelative() {
 
   m_pixelPerFreq = ((p_width - (p_offsetRight + p_paddingRight)) -
                     (p_offsetLeft + p_paddingLeft)) /
-                   p_signalData->freqRange();
+                   m_freqRange;
 
   m_dataPerPixel = 1 / m_pixelPerData;
 
   m_freqPerPixel = 1 / m_pixelPerFreq;
 }
 
-void SpectrumWaveform::setTop() {
-  m_isTop = true;
-  m_isBottom = false;
+void SpectrumWaveform::setTop() { m_position = Top; }
 
-  setOffset(p_offsetLeft, p_offsetRight, (p_maxTextHeight + 5) * 2, 10);
-  updateRelative();
-}
+void SpectrumWaveform::setMiddle() { m_position = Middle; }
 
-void SpectrumWaveform::setMiddle() {
-  m_isTop = false;
-  m_isBottom = false;
-
-  setOffset(p_offsetLeft, p_offsetRight, 10, 10);
-  updateRelative();
-}
-
-void SpectrumWaveform::setBottom() {
-  m_isTop = false;
-  m_isBottom = true;
-
-  setOffset(p_offsetLeft, p_offsetRight, 10, (p_maxTextHeight + 5) * 2);
-  updateRelative();
-}
+void SpectrumWaveform::setBottom() { m_position = Bottom; }
 
 void SpectrumWaveform::mousePressEvent(QMouseEvent *event) {
   if (event->button() != Qt::LeftButton) return;
@@ -177,14 +181,12 @@ void SpectrumWaveform::mouseReleaseEvent(QMouseEvent *event) {
     p_signalData->spectrumCalculateArrayRange();
     p_signalData->setSpectrumSelected(true);
 
-    updateRelative();
-
     emit p_signalData->changedSpectrumFreqRange();
   }
 
   if (m_isToolTipShow) {
     m_isToolTipShow = false;
-    drawWaveform();
+    update();
   }
 }
 
@@ -225,7 +227,7 @@ void SpectrumWaveform::keyReleaseEvent(QKeyEvent *event) {
     m_isCtrlPressed = false;
     if (m_isToolTipShow) {
       m_isToolTipShow = false;
-      drawWaveform();
+      update();
     }
   }
 }
@@ -309,17 +311,11 @@ void SpectrumWaveform::initSelection(QMouseEvent *event) {
   m_selectionRect = QRect();
 }
 
-void SpectrumWaveform::onChangedEnableGrid() { drawWaveform(); }
+void SpectrumWaveform::onChangedEnableGrid() { scheduleWaveform(); }
 
-void SpectrumWaveform::onChangedGraphTimeRange() {
-  updateRelative();
-  drawWaveform();
-}
+void SpectrumWaveform::onChangedGraphTimeRange() { scheduleWaveform(); }
 
-void SpectrumWaveform::onChangedGlobalScale() {
-  updateRelative();
-  drawWaveform();
-}
+void SpectrumWaveform::onChangedGlobalScale() { scheduleWaveform(); }
 
 void SpectrumWaveform::drawName() {
   if (isImageNull()) throw BaseWaveform::ImageIsNull();
@@ -357,7 +353,7 @@ void SpectrumWaveform::drawName() {
   textRect.setHeight(p_maxTextHeight * 2);
 
   painter.drawText(textRect, Qt::AlignCenter | Qt::TextWordWrap,
-                   p_signalData->channelsName()[p_number]);
+                   p_name);
 }
 
 void SpectrumWaveform::drawAxisY() {
@@ -440,7 +436,7 @@ void SpectrumWaveform::drawAxisY() {
 void SpectrumWaveform::drawAxisTopX() {
   if (isImageNull()) throw BaseWaveform::ImageIsNull();
 
-  double freqRange = p_signalData->freqRange();
+  double freqRange = m_freqRange;
 
   QPainter painter(&p_image);
   painter.setPen(QPen(p_mainColor, p_axisLineWidth));
@@ -469,7 +465,7 @@ void SpectrumWaveform::drawAxisTopX() {
     }
   }
 
-  double curValue = p_signalData->leftFreq() + freqRange;
+  double curValue = m_leftFreq + freqRange;
   curValue -= std::fmod(curValue, delimiter);
 
   int count = 0;
@@ -477,10 +473,9 @@ void SpectrumWaveform::drawAxisTopX() {
   delimiter /= std::pow(10, count);
 
   double step = m_pixelPerFreq * delimiter;
-  int startX = axisEnd.x() -
-               std::abs(m_pixelPerFreq *
-                        (p_signalData->leftFreq() + freqRange - curValue)) +
-               1;
+  int startX =
+      axisEnd.x() -
+      std::abs(m_pixelPerFreq * (m_leftFreq + freqRange - curValue)) + 1;
   for (int i = 0; i < delimitersNumber; ++i) {
     int x = startX - step * i;
     painter.drawLine(QPoint{x, p1}, QPoint{x, p2});
@@ -519,7 +514,7 @@ void SpectrumWaveform::drawAxisTopX() {
 void SpectrumWaveform::drawAxisBottomX() {
   if (isImageNull()) throw BaseWaveform::ImageIsNull();
 
-  double freqRange = p_signalData->freqRange();
+  double freqRange = m_freqRange;
 
   QPainter painter(&p_image);
   painter.setPen(QPen(p_mainColor, p_axisLineWidth));
@@ -549,7 +544,7 @@ void SpectrumWaveform::drawAxisBottomX() {
     }
   }
 
-  double curValue = p_signalData->leftFreq() + freqRange;
+  double curValue = m_leftFreq + freqRange;
   curValue -= std::fmod(curValue, delimiter);
 
   int count = 0;
@@ -557,10 +552,9 @@ void SpectrumWaveform::drawAxisBottomX() {
   delimiter /= std::pow(10, count);
 
   double step = m_pixelPerFreq * delimiter;
-  int startX = axisEnd.x() -
-               std::abs(m_pixelPerFreq *
-                        (p_signalData->leftFreq() + freqRange - curValue)) +
-               1;
+  int startX =
+      axisEnd.x() -
+      std::abs(m_pixelPerFreq * (m_leftFreq + freqRange - curValue)) + 1;
   for (int i = 0; i < delimitersNumber; ++i) {
     int x = startX - step * i;
     painter.drawLine(QPoint{x, p1}, QPoint{x, p2});
@@ -599,9 +593,9 @@ void SpectrumWaveform::drawAxisBottomX() {
 void SpectrumWaveform::drawGrid() {
   if (isImageNull()) throw BaseWaveform::ImageIsNull();
 
-  if (!p_signalData->spectrumIsGridEnabled()) return;
+  if (!m_isGridEnabled) return;
 
-  double freqRange = p_signalData->freqRange();
+  double freqRange = m_freqRange;
 
   QPainter painter(&p_image);
   painter.setPen(QPen(p_gridColor, p_gridLineWidth));
@@ -671,13 +665,12 @@ void SpectrumWaveform::drawGrid() {
   axisEnd = {p_width - (p_offsetRight + p_paddingRight),
              p_offsetTop + p_paddingTop};
 
-  double curValueX = p_signalData->leftFreq() + freqRange;
+  double curValueX = m_leftFreq + freqRange;
   curValueX -= std::fmod(curValueX, freqDelimiter);
 
   double stepX = std::round(m_pixelPerFreq * freqDelimiter);
-  int startX = axisEnd.x() -
-               std::abs(m_pixelPerFreq *
-                        (p_signalData->leftFreq() + freqRange - curValueX));
+  int startX = axisEnd.x() - std::abs(m_pixelPerFreq *
+                                      (m_leftFreq + freqRange - curValueX));
 
   p1 = axisStart.y();
   p2 = axisStart.y() + (p_height - ((p_paddingTop + p_offsetTop) +
@@ -17,11 +17,9 @@ class SpectrumWaveform : public BaseWaveform {
   explicit SpectrumWaveform(std::shared_ptr<SignalData> signalData, int number,
                             std::vector<double> &spectrumData,
                             QWidget *parent = nullptr);
+  ~SpectrumWaveform() override;
 
-  void drawWaveform() override;
-
-  void updateRelative();
-
+  // Положение и данные применяются со следующим кадром.
   void setTop();
   void setMiddle();
   void setBottom();
@@ -34,6 +32,9 @@ class SpectrumWaveform : public BaseWaveform {
   void onChangedGlobalScale();
 
  protected:
+  void prepareWaveform() override;
+  void renderWaveform() override;
+
   void mousePressEvent(QMouseEvent *event) override;
   void mouseMoveEvent(QMouseEvent *event) override;
   void mouseReleaseEvent(QMouseEvent *event) override;
@@ -46,6 +47,10 @@ class SpectrumWaveform : public BaseWaveform {
   void paintEvent(QPaintEvent *event) override;
 
  private:
+  enum Position { Top, Middle, Bottom };
+
+  void updateRelative();
+
   void showToolTip(QMouseEvent *event);
   bool validateToolTipPoint(QMouseEvent *event);
 
@@ -63,6 +68,15 @@ class SpectrumWaveform : public BaseWaveform {
   double m_dataPerPixel;
   double m_freqPerPixel;
 
+  double m_leftFreq;
+  double m_freqRange;
+  bool m_isGridEnabled;
+
+  std::vector<double> m_data;
+  bool m_isDataChanged = false;
+
+  Position m_position = Middle;
+
   bool m_isTop;
   bool m_isBottom;
 
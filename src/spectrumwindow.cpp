@@ -2,8 +2,12 @@
 
 #include <QComboBox>
 #include <QDoubleSpinBox>
+#include <atomic>
 #include <limits>
 
+#include "fft.h"
+#include "parallel.h"
+
 namespace fssp {
 
 SpectrumWindow::SpectrumWindow(std::shared_ptr<SignalData> data,
@@ -23,11 +27,11 @@ SpectrumWindow::SpectrumWindow(std::shared_ptr<SignalData> data,
   m_collision = 0;
   m_smoothing = 0;
 
-  calculate();
+  m_spectrumData = calculate(parameters(), nullptr);
   addWaveforms();
   hideWaveforms();
 
-  onChangedGraphTimeRange();
+  m_signalData->setSpectrumDefault();
   drawWaveforms();
 
   QVBoxLayout *mainLayout = new QVBoxLayout();
@@ -135,13 +139,7 @@ void SpectrumWindow::pushSettingsAcceptButton() {
   m_collision = m_collisionComboBox->currentIndex();
   m_smoothing = m_smoothingValue->value();
 
-  calculate();
-
-  for (int i = 0; i < m_spectrumData.size(); ++i) {
-    m_waveforms[i]->setData(m_spectrumData[i]);
-  }
-
-  drawWaveforms();
+  recalculate(false);
 
   pushSettingsCancelButton();
 }
@@ -197,17 +195,19 @@ void SpectrumWindow::drawWaveforms() {
       m_waveforms[i]->setMiddle();
     }
 
-    m_waveforms[i]->drawWaveform();
     m_waveforms[i]->show();
 
     last = i;
     ++count;
   }
 
-  if (count <= 1) return;
+  if (count > 1) m_waveforms[last]->setBottom();
 
-  m_waveforms[last]->setBottom();
-  m_waveforms[last]->drawWaveform();
+  // Кадры каналов рисуются параллельно в общем пуле потоков и появляются
+  // по мере готовности.
+  for (int i = 0; i < m_waveforms.size(); ++i) {
+    if (m_signalData->visibleWaveforms()[i]) m_waveforms[i]->scheduleWaveform();
+  }
 }
 
 void SpectrumWindow::hideWaveforms() {
@@ -351,140 +351,131 @@ void SpectrumWindow::changeArrayGlobalizationAction() {
 }
 
 void SpectrumWindow::onDataAdded() {
+  m_spectrumData = calculate(parameters(), nullptr);
   addWaveforms();
   hideWaveforms();
   drawWaveforms();
 }
 
-void SpectrumWindow::onChangedGraphTimeRange() {
-  calculate();
+void SpectrumWindow::onChangedGraphTimeRange() { recalculate(true); }
 
-  m_signalData->setSpectrumDefault();
+SpectrumWindow::Parameters SpectrumWindow::parameters() const {
+  Parameters parameters;
 
   for (int i = 0; i < m_signalData->channelsNumber(); ++i) {
-    m_waveforms[i]->setData(m_spectrumData[i]);
+    parameters.channels.push_back(m_signalData->channel(i));
   }
 
-  drawWaveforms();
+  parameters.start = m_signalData->leftArray();
+  parameters.range = m_signalData->arrayRange();
+  parameters.timeForOne = m_signalData->timeForOne();
+
+  parameters.spec = m_spec;
+  parameters.mode = m_mode;
+  parameters.collision = m_collision;
+  parameters.smoothing = m_smoothing;
+
+  return parameters;
 }
 
-void SpectrumWindow::fft(std::vector<base> &a, bool invert) {
-  int n = a.size();
+void SpectrumWindow::recalculate(bool resetFreqRange) {
+  // Новое выделение или настройки отменяют расчет для прежних.
+  JobManager::instance().run<std::vector<std::vector<double>>>(
+      tr("Spectrum"), QString::number(reinterpret_cast<quintptr>(this)), this,
+      [parameters = parameters()](Job &job) {
+        return calculate(parameters, &job);
+      },
+      [this, resetFreqRange](std::vector<std::vector<double>> spectrumData) {
+        // Пока шел расчет, могли добавиться каналы, тогда спектры уже
+        // пересчитаны в onDataAdded.
+        if (spectrumData.size() != m_waveforms.size()) return;
 
-  for (int i = 1, j = 0; i < n; ++i) {
-    int bit = n >> 1;
-    for (; j >= bit; bit >>= 1) j -= bit;
-    j += bit;
-    if (i < j) std::swap(a[i], a[j]);
-  }
+        m_spectrumData = std::move(spectrumData);
 
-  for (int len = 2; len <= n; len <<= 1) {
-    double ang = 2 * M_PI / len * (invert ? -1 : 1);
-    base wlen(cos(ang), sin(ang));
-    for (int i = 0; i < n; i += len) {
-      base w(1);
-      for (int j = 0; j < len / 2; ++j) {
-        base u = a[i + j], v = a[i + j + len / 2] * w;
-        a[i + j] = u + v;
-        a[i + j + len / 2] = u - v;
-        w *= wlen;
-      }
-    }
-  }
-  if (invert)
-    for (int i = 0; i < n; ++i) a[i] /= n;
+        if (resetFreqRange) m_signalData->setSpectrumDefault();
+
+        for (int i = 0; i < m_spectrumData.size(); ++i) {
+          m_waveforms[i]->setData(m_spectrumData[i]);
+        }
+
+        drawWaveforms();
+      });
 }
 
-void SpectrumWindow::calculate() {
+std::vector<std::vector<double>> SpectrumWindow::calculate(
+    const Parameters &parameters, Job *job) {
   size_t tmp = 2;
-  while (tmp < m_signalData->arrayRange()) {
+  while (tmp < parameters.range) {
     tmp *= 2;
   }
 
-  std::vector<std::vector<base>> data = std::vector<std::vector<base>>(
-      m_signalData->channelsNumber(), std::vector<base>(tmp));
+  std::vector<std::vector<double>> spectrumData(
+      parameters.channels.size(), std::vector<double>(tmp / 2));
 
-  for (size_t i = 0; i < m_signalData->channelsNumber(); ++i) {
-    for (size_t j = 0; j < m_signalData->arrayRange(); ++j) {
-      data[i][j] =
-          base(m_signalData->data()[i][j + m_signalData->leftArray()], 0);
-    }
-    for (size_t j = m_signalData->arrayRange(); j < tmp; ++j) {
-      data[i][j] = base(0);
-    }
-  }
+  double L = parameters.smoothing;
 
-  for (size_t i = 0; i < data.size(); ++i) {
-    fft(data[i], false);
-  }
+  std::atomic<size_t> done{0};
 
-  m_spectrumData = std::vector<std::vector<double>>(
-      m_signalData->channelsNumber(), std::vector<double>(tmp / 2));
+  // Каналы независимы, каждый обрабатывается целиком в своей задаче.
+  parallelFor(0, spectrumData.size(), [&](size_t i) {
+    if (job) job->check();
 
-  for (size_t i = 0; i < data.size(); ++i) {
-    for (size_t j = 0; j < m_spectrumData[i].size(); ++j) {
-      m_spectrumData[i][j] = m_signalData->timeForOne() * abs(data[i][j]);
-    }
-  }
+    std::vector<double> &spectrum = spectrumData[i];
 
-  if (m_spec == 1) {
-    for (size_t i = 0; i < m_spectrumData.size(); ++i) {
-      for (size_t j = 0; j < m_spectrumData[i].size(); ++j) {
-        m_spectrumData[i][j] = pow(m_spectrumData[i][j], 2);
-      }
+    std::vector<base> data(tmp, base(0));
+
+    std::vector<double> channel(parameters.range);
+    parameters.channels[i]->read(parameters.start, parameters.range,
+                                 channel.data());
+    for (size_t j = 0; j < parameters.range; ++j) {
+      data[j] = base(channel[j], 0);
     }
-  }
 
-  double L = m_smoothing;
+    fft(data, false);
 
-  // Применение логарифмического мода.
-  if (m_mode == 1) {
-    if (m_spec == 0) {
-      for (size_t i = 0; i < m_spectrumData.size(); ++i) {
-        for (size_t j = 0; j < m_spectrumData[i].size(); ++j) {
-          m_spectrumData[i][j] = 20 * log10(m_spectrumData[i][j]);
-        }
-      }
-    } else {
-      for (size_t i = 0; i < m_spectrumData.size(); ++i) {
-        for (size_t j = 0; j < m_spectrumData[i].size(); ++j) {
-          m_spectrumData[i][j] = 10 * log10(m_spectrumData[i][j]);
-        }
+    for (size_t j = 0; j < spectrum.size(); ++j) {
+      spectrum[j] = parameters.timeForOne * abs(data[j]);
+    }
+
+    if (parameters.spec == 1) {
+      for (size_t j = 0; j < spectrum.size(); ++j) {
+        spectrum[j] = pow(spectrum[j], 2);
       }
     }
-  }
 
-  // Разрешение коллизий.
-  if (m_collision == 0) {
-    for (size_t i = 0; i < m_spectrumData.size(); ++i) {
-      m_spectrumData[i][0] = 0;
+    // Применение логарифмического мода.
+    if (parameters.mode == 1) {
+      double factor = parameters.spec == 0 ? 20 : 10;
+      for (size_t j = 0; j < spectrum.size(); ++j) {
+        spectrum[j] = factor * log10(spectrum[j]);
+      }
     }
-  } else if (m_collision == 2) {
-    for (size_t i = 0; i < m_spectrumData.size(); ++i) {
-      m_spectrumData[i][0] = m_spectrumData[i][1];
+
+    // Разрешение коллизий.
+    if (parameters.collision == 0) {
+      spectrum[0] = 0;
+    } else if (parameters.collision == 2) {
+      spectrum[0] = spectrum[1];
     }
-  }
 
-  // Сглаживание.
-  for (size_t i = 0; i < m_spectrumData.size(); ++i) {
-    QVector<double> tmpV(m_spectrumData[i].size());
-    for (size_t j = 0; j < m_spectrumData[i].size(); ++j) {
-      double tmp = m_spectrumData[i][j];
+    // Сглаживание.
+    std::vector<double> tmpV(spectrum.size());
+    for (size_t j = 0; j < spectrum.size(); ++j) {
+      double tmp = spectrum[j];
 
       for (size_t k = 1; k < L + 1; ++k) {
         if (j < k) {
-          tmp += m_spectrumData[i][k - j];
+          tmp += spectrum[k - j];
         } else {
-          tmp += m_spectrumData[i][j - k];
+          tmp += spectrum[j - k];
         }
       }
 
       for (size_t k = 1; k < L + 1; ++k) {
-        if (j + k >= m_spectrumData[i].size()) {
-          tmp += m_spectrumData[i][m_spectrumData[i].size() - 1 -
-                                   (j + k - m_spectrumData[i].size())];
+        if (j + k >= spectrum.size()) {
+          tmp += spectrum[spectrum.size() - 1 - (j + k - spectrum.size())];
         } else {
-          tmp += m_spectrumData[i][j + k];
+          tmp += spectrum[j + k];
         }
       }
 
@@ -492,10 +483,12 @@ void SpectrumWindow::calculate() {
 
       tmpV[j] = tmp;
     }
-    for (size_t j = 0; j < m_spectrumData[i].size(); ++j) {
-      m_spectrumData[i][j] = tmpV[j];
-    }
-  }
+    spectrum = std::move(tmpV);
+
+    if (job) job->setProgress(double(++done) / spectrumData.size());
+  });
+
+  return spectrumData;
 }
 
 }  // namespace fssp
@@ -14,6 +14,7 @@
 #include <QWidget>
 #include <complex>
 
+#include "job.h"
 #include "signaldata.h"
 #include "spectrumwaveform.h"
 
@@ -37,8 +38,26 @@ class SpectrumWindow : public QGroupBox {
   void onDataAdded();
 
  private:
-  void fft(std::vector<base> &a, bool invert);
-  void calculate();
+  // Копия всего, что нужно расчету спектров в пуле потоков.
+  struct Parameters {
+    std::vector<std::shared_ptr<const ChannelSource>> channels;
+    size_t start;
+    size_t range;
+    double timeForOne;
+
+    int spec;
+    int mode;
+    int collision;
+    double smoothing;
+  };
+
+  Parameters parameters() const;
+
+  static std::vector<std::vector<double>> calculate(
+      const Parameters &parameters, Job *job);
+
+  // Пересчитывает спектры в фоне и показывает их по готовности.
+  void recalculate(bool resetFreqRange);
 
   void addWaveforms();
 
@@ -0,0 +1,224 @@
+#include "statistictablewindow.h"
+
+#include <QDialogButtonBox>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QTextStream>
+#include <QVBoxLayout>
+#include <algorithm>
+#include <atomic>
+
+#include "parallel.h"
+
+namespace fssp {
+
+const std::vector<double> StatisticTableWindow::m_orders = {0.5, 0.05, 0.95,
+                                                            0.99};
+
+StatisticTableWindow::StatisticTableWindow(std::shared_ptr<SignalData> data,
+                                           QWidget *parent)
+    : QDialog{parent} {
+  p_signalData = data;
+
+  setWindowTitle(tr("Statistic table"));
+
+  connect(p_signalData.get(), &SignalData::changedGraphTimeRange, this,
+          &StatisticTableWindow::onGraphTimeRangeChange);
+  connect(p_signalData.get(), &SignalData::dataAdded, this,
+          &StatisticTableWindow::onDataAdded);
+
+  m_table = new QTableWidget(0, 11);
+  m_table->setHorizontalHeaderLabels(
+      {tr("Channel"), tr("Min"), tr("Max"), tr("Average"),
+       tr("Standart derivation"), tr("Asymmetry factor"),
+       tr("Kurtosis factor"), tr("Median"), tr("Quantile 0.05"),
+       tr("Quantile 0.95"), tr("Quantile 0.99")});
+  m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+  m_table->horizontalHeader()->setSectionResizeMode(
+      QHeaderView::ResizeToContents);
+  m_table->setSortingEnabled(true);
+
+  QPushButton *exportButton = new QPushButton(tr("Export..."));
+  connect(exportButton, &QPushButton::clicked, this,
+          &StatisticTableWindow::onExportButtonPress);
+
+  QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Close);
+  connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::close);
+
+  QHBoxLayout *buttonLayout = new QHBoxLayout();
+  buttonLayout->addWidget(exportButton);
+  buttonLayout->addStretch();
+  buttonLayout->addWidget(buttonBox);
+
+  QVBoxLayout *mainLayout = new QVBoxLayout();
+  mainLayout->addWidget(m_table);
+  mainLayout->addLayout(buttonLayout);
+
+  setLayout(mainLayout);
+  resize(1000, 400);
+
+  onDataAdded();
+}
+
+void StatisticTableWindow::onGraphTimeRangeChange() {
+  if (p_signalData->leftArray() == m_leftArray &&
+      p_signalData->rightArray() == m_rightArray) {
+    return;
+  }
+
+  calculateStatistic(0, m_table->rowCount());
+}
+
+void StatisticTableWindow::onDataAdded() {
+  // Уже посчитанные каналы не изменяются, считаются только новые
+  int first = m_table->rowCount();
+  int last = p_signalData->channelsNumber();
+  if (first >= last) return;
+
+  m_table->setSortingEnabled(false);
+
+  m_table->setRowCount(last);
+  for (int i = first; i < last; ++i) {
+    QTableWidgetItem *item =
+        new QTableWidgetItem(p_signalData->channelsName()[i]);
+    item->setData(Qt::UserRole, i);
+    m_table->setItem(i, 0, item);
+  }
+
+  m_table->setSortingEnabled(true);
+
+  if (p_signalData->leftArray() != m_leftArray ||
+      p_signalData->rightArray() != m_rightArray) {
+    first = 0;
+  }
+
+  calculateStatistic(first, last);
+}
+
+int StatisticTableWindow::channelRow(int channel) const {
+  for (int i = 0; i < m_table->rowCount(); ++i) {
+    if (m_table->item(i, 0)->data(Qt::UserRole).toInt() == channel) return i;
+  }
+
+  return -1;
+}
+
+void StatisticTableWindow::calculateStatistic(int first, int last) {
+  m_leftArray = p_signalData->leftArray();
+  m_rightArray = p_signalData->rightArray();
+
+  size_t start = m_leftArray;
+  size_t count = m_rightArray - m_leftArray;
+  if (!count || first >= last) return;
+
+  // Новый расчет отменяет прежний, поэтому забирает и его строки
+  if (m_job) first = std::min(first, m_jobFirst);
+  m_jobFirst = first;
+
+  std::shared_ptr<SignalData> signalData = p_signalData;
+
+  m_job = JobManager::instance().run<std::vector<ChannelStatistic>>(
+      windowTitle(), QString::number(reinterpret_cast<quintptr>(this)), this,
+      [signalData, first, last, start, count](Job &job) {
+        std::vector<ChannelStatistic> statistics(last - first);
+        std::atomic<size_t> done{0};
+
+        // Каналы считаются параллельно, внутри канала параллельно
+        // строятся индексы моментов и квантилей
+        parallelFor(first, last, [&](size_t channel) {
+          job.check();
+
+          ChannelStatistic &statistic = statistics[channel - first];
+          statistic.moments = signalData->channelMoments(channel, start, count);
+          statistic.quantiles =
+              signalData->channelQuantiles(channel, start, count, m_orders);
+
+          job.setProgress(static_cast<double>(++done) / statistics.size());
+        });
+
+        return statistics;
+      },
+      [this, first](std::vector<ChannelStatistic> statistics) {
+        m_job.reset();
+        showStatistic(first, statistics);
+      });
+}
+
+void StatisticTableWindow::showStatistic(
+    int first, const std::vector<ChannelStatistic> &statistics) {
+  // Пока сортировка включена, строки переставляются после каждой ячейки
+  m_table->setSortingEnabled(false);
+
+  for (int channel = first; channel < first + statistics.size(); ++channel) {
+    const ChannelStatistic &statistic = statistics[channel - first];
+
+    std::vector<double> values = {statistic.moments.min(),
+                                  statistic.moments.max(),
+                                  statistic.moments.mean(),
+                                  statistic.moments.standardDeviation(),
+                                  statistic.moments.asymmetry(),
+                                  statistic.moments.kurtosis()};
+    values.insert(values.end(), statistic.quantiles.begin(),
+                  statistic.quantiles.end());
+
+    int row = channelRow(channel);
+    for (size_t i = 0; i < values.size(); ++i) {
+      QTableWidgetItem *item = new QTableWidgetItem();
+      item->setData(Qt::DisplayRole, values[i]);
+      m_table->setItem(row, i + 1, item);
+    }
+  }
+
+  m_table->setSortingEnabled(true);
+}
+
+namespace {
+
+// Поле CSV по RFC 4180: поля с запятыми, кавычками или переводами строк
+// (например, имена каналов перебора "name [a=1, b=2]") берутся в кавычки.
+QString csvField(const QString &text) {
+  bool isQuoted = std::any_of(text.begin(), text.end(), [](QChar symbol) {
+    return symbol == ',' || symbol == '"' || symbol == '\n' || symbol == '\r';
+  });
+  if (!isQuoted) return text;
+
+  return "\"" + QString(text).replace("\"", "\"\"") + "\"";
+}
+
+}  // namespace
+
+void StatisticTableWindow::onExportButtonPress() {
+  QString fileName = QFileDialog::getSaveFileName(
+      this, tr("Export statistic"), QDir::homePath(), tr("CSV files (*.csv)"));
+
+  if (fileName == "") return;
+
+  if (!fileName.endsWith(".csv")) fileName += ".csv";
+
+  QFile out(fileName);
+  if (out.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    QTextStream stream(&out);
+
+    // Строки в текущем порядке сортировки
+    for (int j = 0; j < m_table->columnCount(); ++j) {
+      stream << (j ? "," : "")
+             << csvField(m_table->horizontalHeaderItem(j)->text());
+    }
+    stream << "\n";
+
+    for (int i = 0; i < m_table->rowCount(); ++i) {
+      for (int j = 0; j < m_table->columnCount(); ++j) {
+        QTableWidgetItem *item = m_table->item(i, j);
+        stream << (j ? "," : "") << csvField(item ? item->text() : "");
+      }
+      stream << "\n";
+    }
+
+    out.close();
+  }
+}
+
+}  // namespace fssp
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QDialog>
+#include <QTableWidget>
+#include <QWidget>
+
+#include "job.h"
+#include "signaldata.h"
+
+namespace fssp {
+
+// Таблица статистик всех каналов на выделенном диапазоне. Строки можно
+// сортировать по любому столбцу и сохранять в CSV.
+class StatisticTableWindow : public QDialog {
+  Q_OBJECT
+ public:
+  explicit StatisticTableWindow(std::shared_ptr<SignalData> data,
+                                QWidget *parent = nullptr);
+
+ protected slots:
+  void onGraphTimeRangeChange();
+  void onDataAdded();
+  void onExportButtonPress();
+
+ private:
+  struct ChannelStatistic {
+    Moments moments;
+    std::vector<double> quantiles;
+  };
+
+  // Пересчитывает строки каналов [first, last) в фоне, каналы
+  // обрабатываются параллельно.
+  void calculateStatistic(int first, int last);
+  void showStatistic(int first,
+                     const std::vector<ChannelStatistic> &statistics);
+
+  int channelRow(int channel) const;
+
+  std::shared_ptr<SignalData> p_signalData;
+
+  QTableWidget *m_table;
+
+  // Диапазон, для которого посчитаны строки.
+  int m_leftArray = -1;
+  int m_rightArray = -1;
+
+  // Еще не завершенный расчет и его первая строка.
+  std::shared_ptr<Job> m_job;
+  int m_jobFirst = 0;
+
+  static const std::vector<double> m_orders;
+};
+
+}  // namespace fssp
@@ -1,5 +1,9 @@
 #include "statisticwindow.h"
 
+#include <algorithm>
+
+#include "job.h"
+
 namespace fssp {
 
 StatisticWindow::StatisticWindow(std::shared_ptr<SignalData> data,
@@ -13,9 +17,19 @@ StatisticWindow::StatisticWindow(std::shared_ptr<SignalData> data,
 
   connect(p_signalData.get(), &SignalData::changedGraphTimeRange, this,
           &StatisticWindow::onGraphTimeRangeChange);
+  connect(p_signalData.get(), &SignalData::changingGraphTimeRange, this,
+          &StatisticWindow::onGraphTimeRangeChanging);
 
   p_graph = new QGraphicsView();
 
+  m_spacingComboBox = new QComboBox();
+  m_spacingComboBox->addItem(tr("Linear intervals"));
+  m_spacingComboBox->addItem(tr("Logarithmic intervals"));
+  // Включится, когда фоновый расчет вернет минимум.
+  m_spacingComboBox->setEnabled(false);
+  connect(m_spacingComboBox, &QComboBox::currentIndexChanged, this,
+          &StatisticWindow::onSpacingChange);
+
   setWindowTitle(tr("Statistic of ") +
                  p_signalData->channelsName()[p_curSignal]);
 
@@ -69,9 +83,12 @@ void StatisticWindow::showDialog() {
       new QLabel(tr("Order quantile 0.05: ") + QString::number(p_minQuantile));
   m_maxQuantileLabel =
       new QLabel(tr("Order quantile 0.95: ") + QString::number(p_maxQuantile));
+  m_upperQuantileLabel = new QLabel(tr("Order quantile 0.99: ") +
+                                    QString::number(p_upperQuantile));
 
   textFourLayout->addWidget(m_minQuantileLabel);
   textFourLayout->addWidget(m_maxQuantileLabel);
+  textFourLayout->addWidget(m_upperQuantileLabel);
 
   QHBoxLayout *textLayout = new QHBoxLayout();
   textLayout->addLayout(textOneLayout);
@@ -82,6 +99,7 @@ void StatisticWindow::showDialog() {
   QVBoxLayout *mainLayout = new QVBoxLayout();
 
   mainLayout->addLayout(textLayout);
+  mainLayout->addWidget(m_spacingComboBox);
   mainLayout->addWidget(p_graph);
 
   setLabelsText();
@@ -95,94 +113,121 @@ void StatisticWindow::showDialog() {
 void StatisticWindow::calculateStatistic() {
   if (!p_intervalsNumber) return;
 
-  std::vector<double> data(p_signalData->rightArray() -
-                           p_signalData->leftArray());
-
-  for (int i = p_signalData->leftArray(); i < p_signalData->rightArray(); ++i) {
-    data[i - p_signalData->leftArray()] = p_signalData->data()[p_curSignal][i];
-  }
-
-  // Минимум и максимум
-  p_minValue = *std::min_element(data.begin(), data.end());
-  p_maxValue = *std::max_element(data.begin(), data.end());
-
-  // Среднее
-  for (int i = 0; i < data.size(); ++i) p_avgValue += data[i];
-  p_avgValue /= static_cast<double>(data.size());
-
-  std::vector<int> histogram(p_intervalsNumber);
-  std::sort(data.begin(), data.end());
-
-  size_t j = 0;
-  double max_hist = 0;
-  double h = (p_maxValue - p_minValue) / static_cast<double>(p_intervalsNumber);
-  double cur_right_border = p_minValue + h;
-  for (int i = 0; i < data.size(); ++i) {
-    if (data[i] <= cur_right_border) {
-      histogram[j]++;
-    } else {
-      if (max_hist < static_cast<double>(histogram[j])) {
-        max_hist = static_cast<double>(histogram[j]);
-      }
-      j++;
-      cur_right_border += h;
-    }
-  }
+  size_t start = p_signalData->leftArray();
+  size_t count = p_signalData->rightArray() - p_signalData->leftArray();
+  if (!count) return;
+
+  // Моменты, медиана, квантили и гистограмма считаются в фоне, новое
+  // выделение отменяет расчет для прежнего. Первый запрос моментов строит
+  // индекс канала, поэтому он тоже не выполняется в GUI
+  std::shared_ptr<SignalData> signalData = p_signalData;
+  int channel = p_curSignal;
+  int intervalsNumber = p_intervalsNumber;
+  bool isLogarithmic = m_spacingComboBox->currentIndex() == 1;
+
+  JobManager::instance().run<Statistic>(
+      windowTitle(), QString::number(reinterpret_cast<quintptr>(this)), this,
+      [signalData, channel, start, count, intervalsNumber,
+       isLogarithmic](Job &job) {
+        Moments moments = signalData->channelMoments(channel, start, count);
+
+        job.check();
+
+        // Медиана и квантили: точно для коротких диапазонов, по дайджестам
+        // блоков для длинных
+        std::vector<double> orders = signalData->channelQuantiles(
+            channel, start, count, {0.5, 0.05, 0.95, 0.99});
+
+        job.setProgress(0.5);
+        job.check();
+
+        Histogram histogram = signalData->channelHistogram(
+            channel, start, count,
+            histogramIntervals(moments.min(), moments.max(), intervalsNumber,
+                               isLogarithmic));
+
+        return Statistic{moments, orders, histogram};
+      },
+      [this](Statistic result) {
+        setMoments(result.moments);
+        m_spacingComboBox->setEnabled(p_minValue > 0);
+
+        const std::vector<double> &orders = result.orders;
+
+        p_median = orders[0];
+        p_minQuantile = orders[1];
+        p_maxQuantile = orders[2];
+        p_upperQuantile = orders[3];
+
+        setLabelsText();
+        drawHistogram(result.histogram);
+      });
+}
 
-  // Дисперсия
-  for (int i = 0; i < data.size(); ++i) {
-    p_dispersion += std::pow((data[i] - p_avgValue), 2);
-  }
-  p_dispersion /= static_cast<double>(data.size());
+void StatisticWindow::calculateMoments(size_t start, size_t count) {
+  // Минимум, максимум, среднее и моменты по индексу префиксных сумм
+  setMoments(p_signalData->channelMoments(p_curSignal, start, count));
+}
 
-  // Среднеквадратичное отклонение
-  p_standardDeviation = std::sqrt(p_dispersion);
+void StatisticWindow::setMoments(const Moments &moments) {
+  p_minValue = moments.min();
+  p_maxValue = moments.max();
+  p_avgValue = moments.mean();
 
-  // Коэффициент вариации
+  p_dispersion = moments.dispersion();
+  p_standardDeviation = moments.standardDeviation();
   p_variationFactor = p_standardDeviation / p_avgValue;
+  p_asymmetryFactor = moments.asymmetry();
+  p_kurtosisFactor = moments.kurtosis();
+}
 
-  // Коэффициент ассиметрии
-  for (int i = 0; i < data.size(); ++i) {
-    p_asymmetryFactor += std::pow((data[i] - p_avgValue), 3);
-  }
-  p_asymmetryFactor /= static_cast<double>(data.size());
-  p_asymmetryFactor /= std::pow(p_standardDeviation, 3);
-
-  // Коэффициент эксцесса
-  for (int i = 0; i < data.size(); ++i) {
-    p_kurtosisFactor += pow((data[i] - p_avgValue), 4);
-  }
-  p_kurtosisFactor /= static_cast<double>(data.size());
-  p_kurtosisFactor /= pow(p_standardDeviation, 4);
-  p_kurtosisFactor -= 3;
+Histogram StatisticWindow::histogramIntervals(double min, double max,
+                                              int intervalsNumber,
+                                              bool isLogarithmic) {
+  // Логарифмические интервалы возможны только для положительных значений
+  Histogram::Spacing spacing = isLogarithmic && min > 0
+                                   ? Histogram::Logarithmic
+                                   : Histogram::Linear;
 
-  // Медиана
-  p_median = data[data.size() / 2];
+  return Histogram(min, max, intervalsNumber, spacing);
+}
 
-  // Квантили порядка n
-  p_minQuantile = data[data.size() * 0.05];
-  p_maxQuantile = data[data.size() * 0.95];
+void StatisticWindow::drawHistogram(const Histogram &histogram) {
+  double max_hist = histogram.maxCount();
 
   double width = 940;
   double height = 280;
-  h = (width - 40) / p_intervalsNumber;
+  double h = (width - 40) / p_intervalsNumber;
 
   QGraphicsScene *scene = new QGraphicsScene();
 
   p_graph->setScene(scene);
 
-  for (int i = 0; i < histogram.size(); ++i) {
+  for (int i = 0; i < p_intervalsNumber; ++i) {
     QGraphicsRectItem *item = new QGraphicsRectItem();
 
-    item->setRect(
-        (h * static_cast<double>(i)), 0, h,
-        -(height - 20) * (static_cast<double>(histogram[i]) / max_hist));
+    item->setRect((h * static_cast<double>(i)), 0, h,
+                  -(height - 20) *
+                      (static_cast<double>(histogram.counts()[i]) / max_hist));
 
     item->setBrush(Qt::gray);
     scene->addItem(item);
   }
 }
 
+void StatisticWindow::onSpacingChange() {
+  size_t start = p_signalData->leftArray();
+  size_t count = p_signalData->rightArray() - p_signalData->leftArray();
+  if (!p_intervalsNumber || !count) return;
+
+  m_spacingComboBox->setEnabled(p_minValue > 0);
+
+  drawHistogram(p_signalData->channelHistogram(
+      p_curSignal, start, count,
+      histogramIntervals(p_minValue, p_maxValue, p_intervalsNumber,
+                         m_spacingComboBox->currentIndex() == 1)));
+}
+
 void StatisticWindow::setLabelsText() {
   m_minValueLabel->setText(tr("Minimum value: ") + QString::number(p_minValue));
   m_maxValueLabel->setText(tr("Maximum value: ") + QString::number(p_maxValue));
@@ -205,6 +250,8 @@ void StatisticWindow::setLabelsText() {
                               QString::number(p_minQuantile));
   m_maxQuantileLabel->setText(tr("Order quantile 0.95: ") +
                               QString::number(p_maxQuantile));
+  m_upperQuantileLabel->setText(tr("Order quantile 0.99: ") +
+                                QString::number(p_upperQuantile));
 }
 
 void StatisticWindow::onGraphTimeRangeChange() {
@@ -212,4 +259,15 @@ void StatisticWindow::onGraphTimeRangeChange() {
   setLabelsText();
 }
 
+void StatisticWindow::onGraphTimeRangeChanging(size_t leftArray,
+                                               size_t rightArray) {
+  // Пока выделение изменяется, пересчитываются только моменты. Медиана,
+  // квантили и гистограмма обновятся после отпускания мыши. Пока индекс
+  // моментов строится в фоне, GUI его не ждет.
+  if (!p_signalData->hasMomentIndex(p_curSignal)) return;
+
+  calculateMoments(leftArray, rightArray - leftArray);
+  setLabelsText();
+}
+
 }  // namespace fssp
@@ -24,9 +24,24 @@ class StatisticWindow : public QDialog {
 
  protected slots:
   void onGraphTimeRangeChange();
+  void onGraphTimeRangeChanging(size_t leftArray, size_t rightArray);
+  void onSpacingChange();
 
  private:
+  // Результат фонового расчета по выделенному диапазону.
+  struct Statistic {
+    Moments moments;
+    std::vector<double> orders;
+    Histogram histogram;
+  };
+
   void calculateStatistic();
+  void calculateMoments(size_t start, size_t count);
+  void setMoments(const Moments &moments);
+  static Histogram histogramIntervals(double min, double max,
+                                      int intervalsNumber,
+                                      bool isLogarithmic);
+  void drawHistogram(const Histogram &histogram);
   void showDialog();
   void setLabelsText();
 
@@ -34,6 +49,7 @@ class StatisticWindow : public QDialog {
   std::shared_ptr<SignalData> p_signalData;
 
   QGraphicsView *p_graph;
+  QComboBox *m_spacingComboBox;
 
   QLabel *m_minValueLabel;
   QLabel *m_maxValueLabel;
@@ -50,22 +66,24 @@ class StatisticWindow : public QDialog {
 
   QLabel *m_minQuantileLabel;
   QLabel *m_maxQuantileLabel;
+  QLabel *m_upperQuantileLabel;
 
-  double p_minValue;
-  double p_maxValue;
+  double p_minValue = 0;
+  double p_maxValue = 0;
   double p_avgValue = 0;
 
   double p_dispersion = 0;
-  double p_standardDeviation;
+  double p_standardDeviation = 0;
 
   double p_variationFactor = 0;
   double p_asymmetryFactor = 0;
   double p_kurtosisFactor = 0;
 
-  double p_median;
+  double p_median = 0;
 
-  double p_minQuantile;
-  double p_maxQuantile;
+  double p_minQuantile = 0;
+  double p_maxQuantile = 0;
+  double p_upperQuantile = 0;
 
   int p_intervalsNumber;
   int p_curSignal;
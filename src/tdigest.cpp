@@ -0,0 +1,141 @@
+#include "tdigest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace fssp {
+
+TDigest::TDigest(double compression)
+    : m_compression{compression},
+      m_min{std::numeric_limits<double>::infinity()},
+      m_max{-std::numeric_limits<double>::infinity()} {}
+
+void TDigest::add(const double *data, size_t count) {
+  std::vector<double> values;
+  std::vector<Centroid> centroids;
+
+  for (size_t done = 0; done < count; done += chunkSize) {
+    size_t length = std::min(chunkSize, count - done);
+
+    // Сортируются только новые значения, с центроидами они сливаются.
+    values.clear();
+    for (size_t i = 0; i < length; ++i) {
+      if (!std::isnan(data[done + i])) values.push_back(data[done + i]);
+    }
+    if (values.empty()) continue;
+
+    std::sort(values.begin(), values.end());
+
+    m_min = std::min(m_min, values.front());
+    m_max = std::max(m_max, values.back());
+    m_count += values.size();
+
+    centroids.clear();
+    auto centroid = m_centroids.begin();
+    for (double value : values) {
+      for (; centroid != m_centroids.end() && centroid->mean < value;
+           ++centroid) {
+        centroids.push_back(*centroid);
+      }
+      centroids.push_back({value, 1});
+    }
+    centroids.insert(centroids.end(), centroid, m_centroids.end());
+
+    compress(centroids);
+  }
+}
+
+void TDigest::merge(const TDigest &that) {
+  if (!that.m_count) return;
+
+  std::vector<Centroid> centroids(m_centroids.size() +
+                                  that.m_centroids.size());
+  std::merge(m_centroids.begin(), m_centroids.end(),
+             that.m_centroids.begin(), that.m_centroids.end(),
+             centroids.begin(), [](const Centroid &a, const Centroid &b) {
+               return a.mean < b.mean;
+             });
+
+  m_count += that.m_count;
+  m_min = std::min(m_min, that.m_min);
+  m_max = std::max(m_max, that.m_max);
+
+  compress(centroids);
+}
+
+void TDigest::compress(std::vector<Centroid> &centroids) {
+  m_centroids.clear();
+  if (centroids.empty()) return;
+
+  double total = 0;
+  for (const Centroid &centroid : centroids) total += centroid.weight;
+
+  // Функция масштаба k(q) = compression / (2 pi) * asin(2q - 1): центроид
+  // может занимать не больше единицы по k.
+  double factor = m_compression / (2 * M_PI);
+  auto limit = [&](double q) {
+    double k = factor * std::asin(2 * std::clamp(q, 0., 1.) - 1) + 1;
+    return k >= m_compression / 4 ? 1. : (std::sin(k / factor) + 1) / 2;
+  };
+
+  Centroid current = centroids[0];
+  double weightSoFar = 0;
+  double qLimit = limit(0);
+
+  for (size_t i = 1; i < centroids.size(); ++i) {
+    const Centroid &next = centroids[i];
+
+    double q = (weightSoFar + current.weight + next.weight) / total;
+    if (q <= qLimit) {
+      current.weight += next.weight;
+      current.mean += (next.mean - current.mean) * next.weight / current.weight;
+    } else {
+      m_centroids.push_back(current);
+      weightSoFar += current.weight;
+      qLimit = limit(weightSoFar / total);
+      current = next;
+    }
+  }
+
+  m_centroids.push_back(current);
+}
+
+size_t TDigest::count() const { return m_count; }
+
+double TDigest::quantile(double q) const {
+  if (m_centroids.empty()) return std::numeric_limits<double>::quiet_NaN();
+  if (m_centroids.size() == 1) return m_centroids[0].mean;
+
+  q = std::clamp(q, 0., 1.);
+  double index = q * m_count;
+
+  // Значения между центрами соседних центроидов интерполируются линейно,
+  // до первого и после последнего - до минимума и максимума.
+  const Centroid &first = m_centroids.front();
+  if (index < first.weight / 2) {
+    return m_min + (first.mean - m_min) * index / (first.weight / 2);
+  }
+
+  double center = first.weight / 2;
+  for (size_t i = 0; i + 1 < m_centroids.size(); ++i) {
+    const Centroid &a = m_centroids[i];
+    const Centroid &b = m_centroids[i + 1];
+
+    double nextCenter = center + (a.weight + b.weight) / 2;
+    if (index < nextCenter) {
+      return a.mean + (b.mean - a.mean) * (index - center) /
+                          (nextCenter - center);
+    }
+
+    center = nextCenter;
+  }
+
+  const Centroid &last = m_centroids.back();
+  double rest = m_count - center;
+  if (rest <= 0) return m_max;
+
+  return last.mean + (m_max - last.mean) * (index - center) / rest;
+}
+
+}  // namespace fssp
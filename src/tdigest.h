@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace fssp {
+
+// Приближенное распределение значений (t-digest Даннинга): отсортированные
+// центроиды, размер которых ограничен функцией масштаба, поэтому хвосты
+// распределения описываются точнее середины. Дайджесты частей данных
+// объединяются.
+class TDigest {
+ public:
+  // Чем больше compression, тем больше центроидов и тем меньше ошибка
+  // ранга: на практике около 0.05 / compression, у хвостов меньше.
+  explicit TDigest(double compression = 200);
+
+  void add(const double *data, size_t count);
+  void merge(const TDigest &that);
+
+  size_t count() const;
+
+  // Приближенный квантиль порядка q от 0 до 1.
+  double quantile(double q) const;
+
+ private:
+  struct Centroid {
+    double mean;
+    double weight;
+  };
+
+  // Сливает соседние центроиды, упорядоченные по среднему, пока позволяет
+  // функция масштаба.
+  void compress(std::vector<Centroid> &centroids);
+
+  static constexpr size_t chunkSize = 4096;
+
+  double m_compression;
+
+  std::vector<Centroid> m_centroids;
+  size_t m_count = 0;
+
+  double m_min;
+  double m_max;
+};
+
+}  // namespace fssp
@@ -0,0 +1,107 @@
+#include "tilecache.h"
+
+#include <functional>
+#include <iterator>
+
+namespace fssp {
+
+bool TileCache::Key::operator==(const Key &that) const {
+  return channel == that.channel && range == that.range &&
+         width == that.width && index == that.index && height == that.height &&
+         minValue == that.minValue && maxValue == that.maxValue &&
+         color == that.color;
+}
+
+size_t TileCache::KeyHash::operator()(const Key &key) const {
+  size_t hash = std::hash<const void *>()(key.channel);
+  auto combine = [&hash](size_t value) {
+    hash ^= value + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+  };
+
+  combine(std::hash<size_t>()(key.range));
+  combine(std::hash<int>()(key.width));
+  combine(std::hash<size_t>()(key.index));
+  combine(std::hash<int>()(key.height));
+  combine(std::hash<double>()(key.minValue));
+  combine(std::hash<double>()(key.maxValue));
+  combine(std::hash<unsigned int>()(key.color));
+
+  return hash;
+}
+
+TileCache &TileCache::instance() {
+  static TileCache cache;
+  return cache;
+}
+
+QImage TileCache::find(const Key &key) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  auto found = m_index.find(key);
+  if (found == m_index.end()) return QImage();
+
+  std::list<Entry>::iterator entry = found->second;
+
+  // Адрес удаленного канала мог достаться новому.
+  if (entry->channel.expired()) {
+    erase(entry);
+    return QImage();
+  }
+
+  m_entries.splice(m_entries.begin(), m_entries, entry);
+  return entry->tile;
+}
+
+void TileCache::insert(const Key &key,
+                       const std::shared_ptr<const ChannelSource> &channel,
+                       const QImage &tile) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  auto found = m_index.find(key);
+  if (found != m_index.end()) erase(found->second);
+
+  m_entries.push_front(Entry{key, channel, tile});
+  m_index[key] = m_entries.begin();
+  m_size += tile.sizeInBytes();
+
+  evict();
+}
+
+void TileCache::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_entries.clear();
+  m_index.clear();
+  m_size = 0;
+}
+
+size_t TileCache::size() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_size;
+}
+
+size_t TileCache::budget() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_budget;
+}
+
+void TileCache::setBudget(size_t budget) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_budget = budget;
+  evict();
+}
+
+void TileCache::erase(std::list<Entry>::iterator entry) {
+  m_size -= entry->tile.sizeInBytes();
+  m_index.erase(entry->key);
+  m_entries.erase(entry);
+}
+
+void TileCache::evict() {
+  while (m_size > m_budget && !m_entries.empty()) {
+    erase(std::prev(m_entries.end()));
+  }
+}
+
+}  // namespace fssp
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <QImage>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "channelsource.h"
+
+namespace fssp {
+
+// Кэш отрисованных полос трассы канала шириной tileWidth столбцов. Полосы
+// привязаны к сетке столбцов масштаба, а не к виду, поэтому при сдвиге
+// вида и при возврате к прежнему масштабу вид собирается из готовых полос.
+// Давно не использованные полосы вытесняются, когда занятая память
+// превышает бюджет. Можно вызывать из нескольких потоков.
+class TileCache {
+ public:
+  static constexpr int tileWidth = 256;
+
+  static constexpr size_t defaultBudget = size_t(128) << 20;
+
+  // Отсчет n попадает в столбец n * width / range сетки масштаба, полоса
+  // index занимает столбцы [index * tileWidth, (index + 1) * tileWidth).
+  struct Key {
+    const ChannelSource *channel;
+
+    size_t range;
+    int width;
+
+    size_t index;
+
+    int height;
+    double minValue;
+    double maxValue;
+    QRgb color;
+
+    bool operator==(const Key &that) const;
+  };
+
+  static TileCache &instance();
+
+  // Возвращает нулевое изображение, если полосы нет.
+  QImage find(const Key &key);
+
+  void insert(const Key &key,
+              const std::shared_ptr<const ChannelSource> &channel,
+              const QImage &tile);
+
+  void clear();
+
+  // Занятая полосами память в байтах.
+  size_t size() const;
+
+  size_t budget() const;
+  void setBudget(size_t budget);
+
+ private:
+  TileCache() = default;
+
+  struct KeyHash {
+    size_t operator()(const Key &key) const;
+  };
+
+  // Полоса не продлевает жизнь каналу: полосы удаленного канала
+  // отбрасываются при обращении или вытесняются.
+  struct Entry {
+    Key key;
+    std::weak_ptr<const ChannelSource> channel;
+    QImage tile;
+  };
+
+  void erase(std::list<Entry>::iterator entry);
+  void evict();
+
+  // Последние использованные полосы в начале списка.
+  std::list<Entry> m_entries;
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_index;
+
+  size_t m_size = 0;
+  size_t m_budget = defaultBudget;
+
+  mutable std::mutex m_mutex;
+};
+
+}  // namespace fssp
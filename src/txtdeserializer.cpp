@@ -1,5 +1,10 @@
 #include "txtdeserializer.h"
 
+#include <algorithm>
+
+#include "job.h"
+#include "parallel.h"
+
 namespace fssp {
 
 SignalData TxtDeserializer::operator()(const QString &absoluteFilePath) {
@@ -143,13 +148,38 @@ SignalData TxtDeserializer::operator()(const QString &absoluteFilePath) {
     channels_names.pop_back();
   }
 
-  for (size_t k = 0; k < data_num; ++k) {
-    str = in.readLine();
-    QStringList lineData = str.split(" ");
+  // строки читаются подряд, а разбираются параллельно пачками.
+  const size_t LINES_IN_PACK = 1 << 14;
+  const size_t LINES_IN_TASK = 1 << 10;
+  std::vector<QString> lines;
+
+  // при чтении в фоновой операции - прогресс и отмена между пачками.
+  Job *job = Job::current();
 
-    for (size_t j = 0; j < channels_num; ++j) {
-      data[j][k] = lineData[j].toDouble();
+  for (size_t first = 0; first < data_num; first += LINES_IN_PACK) {
+    if (job) {
+      job->check();
+      job->setProgress(static_cast<double>(first) / data_num);
     }
+
+    size_t last = std::min<size_t>(data_num, first + LINES_IN_PACK);
+
+    lines.clear();
+    for (size_t k = first; k < last; ++k) {
+      lines.push_back(in.readLine());
+    }
+
+    size_t tasks_num = (lines.size() + LINES_IN_TASK - 1) / LINES_IN_TASK;
+    parallelFor(0, tasks_num, [&](size_t task) {
+      size_t end = std::min(lines.size(), (task + 1) * LINES_IN_TASK);
+      for (size_t k = task * LINES_IN_TASK; k < end; ++k) {
+        QStringList lineData = lines[k].split(" ");
+
+        for (size_t j = 0; j < channels_num; ++j) {
+          data[j][first + k] = lineData[j].toDouble();
+        }
+      }
+    });
   }
 
   file.close();
@@ -0,0 +1,158 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "expression.h"
+
+using fssp::Expression;
+
+namespace {
+
+int failures = 0;
+
+const std::vector<std::string> inputs = {"a", "b", "c"};
+
+// Вход i равен (i + 1) * 100 + n.
+void readInput(size_t input, double *output, size_t start, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    output[i] = (input + 1) * 100. + static_cast<double>(start + i);
+  }
+}
+
+double evaluate(const std::string &text, size_t n) {
+  Expression expression(text, inputs, 10);
+
+  double value;
+  expression.evaluate(&value, n, 1, readInput);
+  return value;
+}
+
+void checkValue(const std::string &text, size_t n, double expected) {
+  double value = evaluate(text, n);
+
+  double tolerance = 1e-12 * std::max(1., std::abs(expected));
+  bool ok = std::isinf(expected) ? value == expected
+                                 : std::abs(value - expected) <= tolerance;
+  if (!ok) {
+    std::fprintf(stderr, "FAILED: %s at n=%zu is %.17g, expected %.17g\n",
+                 text.c_str(), n, value, expected);
+    ++failures;
+  }
+}
+
+template <typename Error>
+void checkError(const std::string &text) {
+  try {
+    Expression(text, inputs, 10);
+  } catch (const Error &) {
+    return;
+  } catch (const std::exception &error) {
+    std::fprintf(stderr, "FAILED: %s threw \"%s\"\n", text.c_str(),
+                 error.what());
+    ++failures;
+    return;
+  }
+
+  std::fprintf(stderr, "FAILED: %s was accepted\n", text.c_str());
+  ++failures;
+}
+
+void check(bool condition, const char *message) {
+  if (condition) return;
+
+  std::fprintf(stderr, "FAILED: %s\n", message);
+  ++failures;
+}
+
+}  // namespace
+
+int main() {
+  // Приоритеты и ассоциативность.
+  checkValue("1 + 2 * 3", 0, 7);
+  checkValue("(1 + 2) * 3", 0, 9);
+  checkValue("10 - 4 - 3", 0, 3);
+  checkValue("12 / 3 / 2", 0, 2);
+  checkValue("7 % 4 * 2", 0, 6);
+
+  // Унарный минус связывает слабее степени, степень правоассоциативна.
+  checkValue("-n^2", 3, -9);
+  checkValue("-2^2", 0, -4);
+  checkValue("(-n)^2", 3, 9);
+  checkValue("2^3^2", 0, 512);
+  checkValue("n^3^2", 2, 512);
+  checkValue("n**2**3", 2, 256);
+  checkValue("2^-1", 0, 0.5);
+  checkValue("n^-1", 4, 0.25);
+
+  // Степени, замененные быстрыми командами.
+  checkValue("n^2", 7, 49);
+  checkValue("n^0.5", 9, 3);
+  checkValue("n^1", 5, 5);
+
+  // Деление на константу заменяется умножением на обратную величину,
+  // кроме деления на ноль.
+  checkValue("n / 4", 3, 0.75);
+  checkValue("n / 8 / 2", 4, 0.25);
+  checkValue("n / 0", 1, INFINITY);
+  checkValue("n / (2 - 2)", 1, INFINITY);
+  checkValue("1 / n", 4, 0.25);
+
+  // Переменные, константы и функции.
+  checkValue("t", 25, 2.5);
+  checkValue("fs * 2", 0, 20);
+  checkValue("sin(pi / 2) + max(n, 3) + pow(2, 3)", 5, 14);
+  checkValue("atan2(1, 1) * 4", 0, M_PI);
+
+  // Каналы по имени и по номеру.
+  checkValue("a", 5, 105);
+  checkValue("b + c", 1, 201 + 301);
+  checkValue("ch1", 7, 107);
+  checkValue("ch3 - ch2", 0, 100);
+
+  Expression channels("ch3 * 2 + a + ch3", inputs, 10);
+  check(channels.usedInputs() == std::vector<size_t>({0, 2}),
+        "usedInputs lists each used channel once, in order");
+
+  checkError<Expression::UnknownName>("ch0");
+  checkError<Expression::UnknownName>("ch4");
+  checkError<Expression::UnknownName>("x");
+  checkError<Expression::UnknownName>("foo(1)");
+  checkError<Expression::SyntaxError>("1 +");
+  checkError<Expression::SyntaxError>("(1 + 2");
+  checkError<Expression::SyntaxError>("1 2");
+  checkError<Expression::SyntaxError>("");
+  checkError<Expression::WrongArgumentsNumber>("sin(1, 2)");
+  checkError<Expression::WrongArgumentsNumber>("max(n)");
+
+  // Длинное выражение с переиспользованием регистров на нескольких блоках.
+  std::string text = "(n + 1) * (n + 2) * (n + 3) - (n + 4) * (a - 100) + "
+                     "sqrt(abs(b - 200 - n)) + (n % 7) * (c - 300)";
+  Expression expression(text, inputs, 10);
+
+  size_t start = 1000;
+  size_t count = 3 * Expression::blockSize + 17;
+  std::vector<double> values(count);
+  expression.evaluate(values.data(), start, count, readInput);
+
+  for (size_t i = 0; i < count; ++i) {
+    double n = static_cast<double>(start + i);
+    double expected = (n + 1) * (n + 2) * (n + 3) - (n + 4) * n +
+                      std::fmod(n, 7) * n;
+    if (std::abs(values[i] - expected) > 1e-9 * std::abs(expected)) {
+      std::fprintf(stderr,
+                   "FAILED: long expression at n=%g is %g, expected %g\n", n,
+                   values[i], expected);
+      ++failures;
+      break;
+    }
+  }
+
+  if (failures) {
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,86 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "channelsource.h"
+#include "momentindex.h"
+
+using fssp::MomentIndex;
+using fssp::Moments;
+using fssp::StoredChannel;
+
+namespace {
+
+int failures = 0;
+
+bool isClose(double value, double expected, double tolerance) {
+  return std::abs(value - expected) <=
+         tolerance * std::max(1., std::abs(expected));
+}
+
+void checkRange(const StoredChannel &channel, const MomentIndex &index,
+                size_t start, size_t count) {
+  Moments expected;
+  expected.add(channel.samples() + start, count);
+
+  Moments moments = index.moments(channel, start, count);
+
+  bool ok = moments.count() == expected.count() &&
+            moments.min() == expected.min() &&
+            moments.max() == expected.max() &&
+            isClose(moments.mean(), expected.mean(), 1e-12) &&
+            isClose(moments.dispersion(), expected.dispersion(), 1e-9) &&
+            isClose(moments.asymmetry(), expected.asymmetry(), 1e-6) &&
+            isClose(moments.kurtosis(), expected.kurtosis(), 1e-6);
+
+  if (!ok) {
+    std::fprintf(stderr,
+                 "FAILED: [%zu, +%zu) dispersion %g, expected %g; "
+                 "asymmetry %g, expected %g; kurtosis %g, expected %g\n",
+                 start, count, moments.dispersion(), expected.dispersion(),
+                 moments.asymmetry(), expected.asymmetry(),
+                 moments.kurtosis(), expected.kurtosis());
+    ++failures;
+  }
+}
+
+}  // namespace
+
+int main() {
+  constexpr size_t size = 1 << 20;
+
+  // Ступенька 1e6 в середине канала и шум 1e-3: среднее половины канала
+  // далеко от среднего всего канала.
+  std::mt19937_64 generator(1);
+  std::normal_distribution<double> noise(0., 1e-3);
+
+  std::vector<double> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = (i < size / 2 ? 0. : 1e6) + noise(generator);
+  }
+
+  StoredChannel channel(std::move(data));
+  MomentIndex index(channel);
+
+  checkRange(channel, index, size / 2 + 1000, size / 4);
+  checkRange(channel, index, 123, size / 2 - 1000);
+  checkRange(channel, index, 0, size);
+  checkRange(channel, index, 17, 4000);
+  checkRange(channel, index, size - 5000, 5000);
+
+  std::uniform_int_distribution<size_t> position(0, size - 1);
+  for (int i = 0; i < 200; ++i) {
+    size_t start = position(generator);
+    size_t count = position(generator) % (size - start) + 1;
+    checkRange(channel, index, start, count);
+  }
+
+  if (failures) {
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,88 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "resampler.h"
+
+using fssp::Resampler;
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char *message) {
+  if (condition) return;
+
+  std::fprintf(stderr, "FAILED: %s\n", message);
+  ++failures;
+}
+
+void checkRatio(double ratio, int expectedUp, int expectedDown) {
+  int upFactor = 0;
+  int downFactor = 0;
+  Resampler::approximateRatio(ratio, upFactor, downFactor);
+
+  if (upFactor != expectedUp || downFactor != expectedDown) {
+    std::fprintf(stderr, "FAILED: %g -> %d/%d, expected %d/%d\n", ratio,
+                 upFactor, downFactor, expectedUp, expectedDown);
+    ++failures;
+  }
+}
+
+bool isUnsupported(double ratio) {
+  int upFactor = 0;
+  int downFactor = 0;
+  try {
+    Resampler::approximateRatio(ratio, upFactor, downFactor);
+  } catch (const Resampler::UnsupportedRatio &) {
+    return true;
+  }
+  return false;
+}
+
+bool isInvalid(double ratio) {
+  int upFactor = 0;
+  int downFactor = 0;
+  try {
+    Resampler::approximateRatio(ratio, upFactor, downFactor);
+  } catch (const Resampler::InvalidRatio &) {
+    return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+int main() {
+  checkRatio(1, 1, 1);
+  checkRatio(2, 2, 1);
+  checkRatio(0.5, 1, 2);
+  checkRatio(44100. / 48000., 147, 160);
+  checkRatio(1000, 1000, 1);
+  checkRatio(0.001, 1, 1000);
+
+  // Приближение в пределах множителей.
+  int upFactor = 0;
+  int downFactor = 0;
+  Resampler::approximateRatio(M_PI, upFactor, downFactor);
+  check(upFactor <= 1000 && downFactor <= 1000, "pi factors are bounded");
+  check(std::abs(static_cast<double>(upFactor) / downFactor - M_PI) < 1e-6,
+        "pi is approximated");
+
+  // Отношения вне границ не превращаются молча в 1/1.
+  check(isUnsupported(3000), "3000 is unsupported");
+  check(isUnsupported(0.0001), "0.0001 is unsupported");
+  check(isUnsupported(1000.5), "1000.5 is unsupported");
+
+  check(isInvalid(0), "0 is invalid");
+  check(isInvalid(-2), "-2 is invalid");
+  check(isInvalid(NAN), "NaN is invalid");
+  check(isInvalid(INFINITY), "infinity is invalid");
+
+  std::vector<double> data(1000, 1.);
+  std::vector<double> result = Resampler::resample(data, 3, 2);
+  check(result.size() == 1500, "output size follows the ratio");
+
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}